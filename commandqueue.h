@@ -0,0 +1,80 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free queue for many producer threads and one consumer
+// (Vyukov's array queue). Each cell carries a sequence number saying whose
+// turn it is: a producer claims a position with one compare-and-swap on
+// the tail and publishes its value by bumping the cell's sequence; the
+// consumer takes values in claim order and hands the cell back the same
+// way. Nothing blocks: a full queue makes tryPush fail, and a value still
+// being written makes tryPop report empty until it is published.
+template<typename T>
+class CommandQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static const size_t CACHE_LINE = 64;
+
+    Cell* cells;
+    size_t mask;                                        // capacity - 1; capacity is a power of two
+    alignas(CACHE_LINE) std::atomic<size_t> tail;       // next position for a producer
+    alignas(CACHE_LINE) size_t head;                    // next position for the consumer
+
+public:
+    // Holds up to capacity values, rounded up to a power of two
+    explicit CommandQueue(size_t capacity) : tail(0), head(0) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        cells = new Cell[size];
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~CommandQueue() { delete[] cells; }
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    // Any thread. Returns false if the queue is full.
+    bool tryPush(const T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t lag = (intptr_t)sequence - (intptr_t)position;
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;                           // the consumer hasn't freed this cell yet
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. Returns false if nothing is ready.
+    bool tryPop(T& value) {
+        Cell& cell = cells[head & mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if ((intptr_t)sequence - (intptr_t)(head + 1) < 0) return false;
+        value = cell.value;
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+};
+
+#endif // COMMAND_QUEUE_H
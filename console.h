@@ -0,0 +1,47 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+// Unbuffered keyboard input for the interactive menus: conio.h on Windows,
+// and _kbhit / _getch built on termios everywhere else.
+#ifdef _WIN32
+#include <conio.h>
+#else
+#include <termios.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+// Whether a key is waiting to be read
+inline int _kbhit() {
+    termios saved, raw;
+    tcgetattr(STDIN_FILENO, &saved);
+    raw = saved;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(STDIN_FILENO, &readable);
+    timeval noWait{0, 0};
+    int ready = select(STDIN_FILENO + 1, &readable, nullptr, nullptr, &noWait);
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    return ready > 0;
+}
+
+// Reads one key without echo or waiting for Enter
+inline int _getch() {
+    termios saved, raw;
+    tcgetattr(STDIN_FILENO, &saved);
+    raw = saved;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+
+    unsigned char c = 0;
+    int result = read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    return result;
+}
+#endif
+
+#endif // CONSOLE_H
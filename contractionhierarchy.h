@@ -0,0 +1,381 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <climits>
+#include "graph.h"
+#include "heap.h"
+#include "dynamicarray.h"
+#include "searchworkspace.h"
+
+// Contraction Hierarchies speed-up for point-to-point routing.
+//
+// Preprocessing contracts the intersections one at a time in order of
+// importance. Each contracted vertex v is removed from the graph, and a
+// shortcut u -> x with weight w(u,v) + w(v,x) is added wherever u -> v -> x
+// was the only shortest connection (checked with a bounded witness search).
+// A query then runs a bidirectional Dijkstra that only ever moves to
+// higher-ranked vertices, which settles a few hundred vertices even on very
+// large networks. Shortcuts remember the vertex they skip, so routes can be
+// unpacked back into the original intersections.
+//
+// The hierarchy is built for the weights the graph has at construction time;
+// isCurrent() tells when the graph has changed since. It can also be built
+// from a CSR copy of the roads, so contraction can run on another thread
+// while the graph itself keeps changing (see HierarchyBuilder).
+class ContractionHierarchy {
+private:
+    struct Arc {
+        int to;
+        int weight;
+        int middle;     // vertex the shortcut skips, -1 for an original road
+    };
+
+    // Witness searches give up after this many settled vertices; a missed
+    // witness only costs an unnecessary shortcut, never a wrong route
+    static const int WITNESS_SETTLE_LIMIT = 100;
+    static const int SIMULATION_SETTLE_LIMIT = 10;
+
+    int numVertices;
+    unsigned long builtForVersion;
+    int* rank;          // contraction order, higher = more important
+
+    // Upward search graph in CSR form. up[u] holds u -> x with rank[x] > rank[u];
+    // down[u] holds x -> u with rank[x] > rank[u], stored with to = x.
+    int* upOffsets;
+    Arc* upArcs;
+    int* downOffsets;
+    Arc* downArcs;
+
+    // ---- preprocessing state, only alive inside the constructor ----
+
+    // Remaining (uncontracted) graph: out[u] arcs u -> to, in[u] arcs to -> u
+    DynamicArray<Arc>* out;
+    DynamicArray<Arc>* in;
+    bool* contracted;
+    int* contractedNeighbors;
+
+    static int findArc(const DynamicArray<Arc>& arcs, int to) {
+        for (size_t i = 0; i < arcs.size(); i++) {
+            if (arcs[i].to == to) return (int)i;
+        }
+        return -1;
+    }
+
+    static void removeArc(DynamicArray<Arc>& arcs, int to) {
+        int i = findArc(arcs, to);
+        if (i != -1) {
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+        }
+    }
+
+    // Adds u -> x, or lowers the weight of the existing arc between them
+    void addOrImprove(int u, int x, int weight, int middle) {
+        int i = findArc(out[u], x);
+        if (i == -1) {
+            out[u].push_back(Arc{x, weight, middle});
+            in[x].push_back(Arc{u, weight, middle});
+        } else if (weight < out[u][i].weight) {
+            out[u][i].weight = weight;
+            out[u][i].middle = middle;
+            int j = findArc(in[x], u);
+            in[x][j].weight = weight;
+            in[x][j].middle = middle;
+        }
+    }
+
+    // Dijkstra from source over the remaining graph without `skip`, stopping
+    // past maxDist or after settleLimit vertices
+    void witnessSearch(int source, int skip, int maxDist, int settleLimit, SearchWorkspace& workspace) {
+        workspace.begin(numVertices);
+        workspace.setDistance(source, 0, -1);
+        workspace.queue.push(source, 0);
+        int settled = 0;
+        while (!workspace.queue.empty() && settled < settleLimit) {
+            if (workspace.queue.topPriority() > maxDist) break;
+            int u = workspace.queue.pop();
+            workspace.settle(u);
+            settled++;
+            int distU = workspace.distance(u);
+            for (size_t i = 0; i < out[u].size(); i++) {
+                int v = out[u][i].to;
+                if (v == skip) continue;
+                int newDist = distU + out[u][i].weight;
+                if (!workspace.isSettled(v) && newDist < workspace.distance(v)) {
+                    workspace.setDistance(v, newDist, u);
+                    workspace.queue.pushOrDecrease(v, newDist);
+                }
+            }
+        }
+    }
+
+    // Contracts v (or, when simulate is true, only counts the shortcuts
+    // contracting it would need). Returns the number of shortcuts.
+    int contract(int v, bool simulate, SearchWorkspace& workspace) {
+        int shortcuts = 0;
+        int maxOut = 0;
+        for (size_t j = 0; j < out[v].size(); j++) {
+            if (out[v][j].weight > maxOut) maxOut = out[v][j].weight;
+        }
+
+        for (size_t i = 0; i < in[v].size(); i++) {
+            int u = in[v][i].to;
+            int toV = in[v][i].weight;
+            witnessSearch(u, v, toV + maxOut,
+                          simulate ? SIMULATION_SETTLE_LIMIT : WITNESS_SETTLE_LIMIT, workspace);
+
+            for (size_t j = 0; j < out[v].size(); j++) {
+                int x = out[v][j].to;
+                if (x == u) continue;
+                int viaV = toV + out[v][j].weight;
+                if (workspace.distance(x) <= viaV) continue;  // witness found
+                shortcuts++;
+                if (!simulate) {
+                    addOrImprove(u, x, viaV, v);
+                }
+            }
+        }
+        return shortcuts;
+    }
+
+    // Vertices that add few shortcuts and sit in already-thinned regions go first
+    int importance(int v, SearchWorkspace& workspace) {
+        int edgeDifference = contract(v, true, workspace) - (int)in[v].size() - (int)out[v].size();
+        return 2 * edgeDifference + contractedNeighbors[v];
+    }
+
+    // Copies per-vertex arc lists into CSR arrays
+    static void flatten(int n, DynamicArray<Arc>* lists, int*& offsets, Arc*& arcs) {
+        offsets = new int[n + 1];
+        offsets[0] = 0;
+        for (int u = 0; u < n; u++) {
+            offsets[u + 1] = offsets[u] + (int)lists[u].size();
+        }
+        arcs = new Arc[offsets[n] > 0 ? offsets[n] : 1];
+        for (int u = 0; u < n; u++) {
+            for (size_t i = 0; i < lists[u].size(); i++) {
+                arcs[offsets[u] + i] = lists[u][i];
+            }
+        }
+    }
+
+    // The arc a -> b of the search graph (it is stored at the lower-ranked end)
+    const Arc* arcBetween(int a, int b) const {
+        if (rank[a] < rank[b]) {
+            for (int i = upOffsets[a]; i < upOffsets[a + 1]; i++) {
+                if (upArcs[i].to == b) return &upArcs[i];
+            }
+        } else {
+            for (int i = downOffsets[b]; i < downOffsets[b + 1]; i++) {
+                if (downArcs[i].to == a) return &downArcs[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Appends the original intersections of the arc a -> b, excluding a
+    void unpackArc(int a, int b, DynamicArray<int>& path) const {
+        DynamicArray<int> stack;    // pending (from, to) pairs, top = next to emit
+        stack.push_back(b);
+        stack.push_back(a);
+        while (!stack.empty()) {
+            int from = stack.back();
+            stack.pop_back();
+            int to = stack.back();
+            stack.pop_back();
+            const Arc* arc = arcBetween(from, to);
+            if (arc == nullptr || arc->middle == -1) {
+                path.push_back(to);
+            } else {
+                stack.push_back(to);
+                stack.push_back(arc->middle);
+                stack.push_back(arc->middle);
+                stack.push_back(from);
+            }
+        }
+    }
+
+public:
+    explicit ContractionHierarchy(DirectedWeightedGraph& graph)
+        : ContractionHierarchy(graph.getSnapshot(), graph.getVersion()) {}
+
+    // Contracts csr, which holds the roads of the graph at version
+    ContractionHierarchy(const CSRGraph& csr, unsigned long version)
+        : numVertices(csr.getNumVertices()), builtForVersion(version) {
+        rank = new int[numVertices > 0 ? numVertices : 1];
+        out = new DynamicArray<Arc>[numVertices > 0 ? numVertices : 1];
+        in = new DynamicArray<Arc>[numVertices > 0 ? numVertices : 1];
+        contracted = new bool[numVertices > 0 ? numVertices : 1]();
+        contractedNeighbors = new int[numVertices > 0 ? numVertices : 1]();
+        DynamicArray<Arc>* up = new DynamicArray<Arc>[numVertices > 0 ? numVertices : 1];
+        DynamicArray<Arc>* down = new DynamicArray<Arc>[numVertices > 0 ? numVertices : 1];
+
+        for (int u = 0; u < numVertices; u++) {
+            for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+                if (csr.target(e) != u) {
+                    addOrImprove(u, csr.target(e), csr.weight(e), -1);
+                }
+            }
+        }
+
+        SearchWorkspace workspace;
+        IndexedPriorityQueue<int> order(numVertices > 0 ? numVertices : 1);
+        for (int v = 0; v < numVertices; v++) {
+            order.push(v, importance(v, workspace));
+        }
+
+        int nextRank = 0;
+        while (!order.empty()) {
+            int v = order.pop();
+
+            // Lazy update: importance may have grown since v was queued
+            int current = importance(v, workspace);
+            if (!order.empty() && current > order.topPriority()) {
+                order.push(v, current);
+                continue;
+            }
+
+            contract(v, false, workspace);
+            rank[v] = nextRank++;
+            contracted[v] = true;
+
+            // Everything still attached to v is ranked higher than v
+            up[v] = out[v];
+            down[v] = in[v];
+            for (size_t i = 0; i < out[v].size(); i++) {
+                int x = out[v][i].to;
+                removeArc(in[x], v);
+                contractedNeighbors[x]++;
+            }
+            for (size_t i = 0; i < in[v].size(); i++) {
+                int u = in[v][i].to;
+                removeArc(out[u], v);
+                contractedNeighbors[u]++;
+            }
+            out[v].clear();
+            in[v].clear();
+
+            // The neighbours' degrees changed, so refresh their importance
+            for (size_t i = 0; i < up[v].size(); i++) {
+                int x = up[v][i].to;
+                order.changeKey(x, importance(x, workspace));
+            }
+            for (size_t i = 0; i < down[v].size(); i++) {
+                int u = down[v][i].to;
+                order.changeKey(u, importance(u, workspace));
+            }
+        }
+
+        flatten(numVertices, up, upOffsets, upArcs);
+        flatten(numVertices, down, downOffsets, downArcs);
+
+        delete[] up;
+        delete[] down;
+        delete[] out;
+        delete[] in;
+        delete[] contracted;
+        delete[] contractedNeighbors;
+        out = nullptr;
+        in = nullptr;
+        contracted = nullptr;
+        contractedNeighbors = nullptr;
+    }
+
+    ~ContractionHierarchy() {
+        delete[] rank;
+        delete[] upOffsets;
+        delete[] upArcs;
+        delete[] downOffsets;
+        delete[] downArcs;
+    }
+
+    ContractionHierarchy(const ContractionHierarchy&) = delete;
+    ContractionHierarchy& operator=(const ContractionHierarchy&) = delete;
+
+    // False once the graph has been changed after the hierarchy was built
+    bool isCurrent(const DirectedWeightedGraph& graph) const {
+        return graph.getVersion() == builtForVersion && graph.getNumVertices() == numVertices;
+    }
+
+    int getNumArcs() const { return upOffsets[numVertices] + downOffsets[numVertices]; }
+
+    // Shortest route from source to destination as a list of intersections,
+    // shortcuts already unpacked. Same contract as DirectedWeightedGraph::dijkstra:
+    // returns the number of vertices, 0 if unreachable.
+    int query(int source, int destination, DynamicArray<int>& path,
+              SearchWorkspace& forward = SearchWorkspace::forThisThread(),
+              SearchWorkspace& backward = SearchWorkspace::reverseForThisThread()) const {
+        path.clear();
+        if (source < 0 || source >= numVertices || destination < 0 || destination >= numVertices) {
+            return 0;
+        }
+
+        forward.begin(numVertices);
+        backward.begin(numVertices);
+        forward.setDistance(source, 0, -1);
+        forward.queue.push(source, 0);
+        backward.setDistance(destination, 0, -1);
+        backward.queue.push(destination, 0);
+
+        int best = source == destination ? 0 : INT_MAX;
+        int meeting = source == destination ? source : -1;
+
+        while (!forward.queue.empty() || !backward.queue.empty()) {
+            bool goForward = !forward.queue.empty() &&
+                (backward.queue.empty() || forward.queue.topPriority() <= backward.queue.topPriority());
+            SearchWorkspace& side = goForward ? forward : backward;
+            SearchWorkspace& other = goForward ? backward : forward;
+
+            // Both searches only go upward; nothing left can beat best
+            if (side.queue.topPriority() >= best) break;
+
+            int u = side.queue.pop();
+            side.settle(u);
+            int distU = side.distance(u);
+
+            // Stall-on-demand: if a higher vertex already reaches u more cheaply
+            // (through an arc the search cannot use), u's distance is not a
+            // shortest one and expanding it would be wasted work
+            const int* stallOffsets = goForward ? downOffsets : upOffsets;
+            const Arc* stallArcs = goForward ? downArcs : upArcs;
+            bool stalled = false;
+            for (int i = stallOffsets[u]; i < stallOffsets[u + 1] && !stalled; i++) {
+                int x = stallArcs[i].to;
+                stalled = side.distance(x) != INT_MAX && side.distance(x) + stallArcs[i].weight < distU;
+            }
+            if (stalled) continue;
+
+            const int* offsets = goForward ? upOffsets : downOffsets;
+            const Arc* arcs = goForward ? upArcs : downArcs;
+            for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+                int v = arcs[i].to;
+                int newDist = distU + arcs[i].weight;
+                if (!side.isSettled(v) && newDist < side.distance(v)) {
+                    side.setDistance(v, newDist, u);
+                    side.queue.pushOrDecrease(v, newDist);
+                }
+                if (other.distance(v) != INT_MAX && newDist + other.distance(v) < best) {
+                    best = newDist + other.distance(v);
+                    meeting = v;
+                }
+            }
+        }
+
+        if (meeting == -1) return 0;
+
+        // Search-graph route: source .. meeting .. destination
+        DynamicArray<int> upward;
+        forward.buildPath(meeting, upward);
+        for (int node = backward.parent(meeting); node != -1; node = backward.parent(node)) {
+            upward.push_back(node);
+        }
+
+        path.push_back(upward[0]);
+        for (size_t i = 0; i + 1 < upward.size(); i++) {
+            unpackArc(upward[i], upward[i + 1], path);
+        }
+        return (int)path.size();
+    }
+};
+
+#endif // CONTRACTION_HIERARCHY_H
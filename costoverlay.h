@@ -0,0 +1,140 @@
+#ifndef COST_OVERLAY_H
+#define COST_OVERLAY_H
+
+#include <climits>
+#include "graph.h"
+#include "dynamicarray.h"
+
+// Live travel costs on top of the road weights, one slot per edge id of the
+// graph's CSR snapshot: a closed road costs INT_MAX, a congested one its
+// weight plus a penalty. Closures and congestion update single edges as they
+// happen, and route searches read getCosts() directly, so no search looks up
+// road keys or touches the graph's weights.
+//
+// Edge ids are those of the snapshot the overlay was created for; adding
+// edges to the graph afterwards renumbers them and clears the overlay.
+class EdgeCostOverlay {
+private:
+    DirectedWeightedGraph& graph;
+    DynamicArray<int> cost;        // what searches use
+    DynamicArray<int> penalty;
+    DynamicArray<bool> blocked;
+    DynamicArray<int> changed;     // edges whose cost changed since takeChangedEdges()
+    DynamicArray<bool> isChanged;
+    int numEdges;
+    int numBlocked;
+    unsigned long weightVersion;   // graph version the costs were derived from
+    unsigned long version;         // bumped whenever any cost changes
+    unsigned long closureVersion;  // bumped when a road is closed or reopened
+
+    void recompute(int e, const CSRGraph& csr) {
+        int newCost = blocked[e] ? INT_MAX : csr.weight(e) + penalty[e];
+        if (newCost != cost[e]) {
+            if ((newCost == INT_MAX) != (cost[e] == INT_MAX)) closureVersion++;
+            cost[e] = newCost;
+            version++;
+            if (!isChanged[e]) {
+                isChanged[e] = true;
+                changed.push_back(e);
+            }
+        }
+    }
+
+    // Follows weight updates (and rebuilds after edges were added)
+    void sync() {
+        if (weightVersion == graph.getVersion()) return;
+        const CSRGraph& csr = graph.getSnapshot();
+        if (csr.getNumEdges() != numEdges) {
+            numEdges = csr.getNumEdges();
+            cost.resize(numEdges);
+            penalty.resize(numEdges);
+            blocked.resize(numEdges);
+            isChanged.resize(numEdges);
+            changed.clear();
+            numBlocked = 0;
+            for (int e = 0; e < numEdges; e++) {
+                penalty[e] = 0;
+                blocked[e] = false;
+                isChanged[e] = false;
+            }
+        }
+        for (int e = 0; e < numEdges; e++) {
+            recompute(e, csr);
+        }
+        weightVersion = graph.getVersion();
+    }
+
+public:
+    explicit EdgeCostOverlay(DirectedWeightedGraph& g)
+        : graph(g), numEdges(0), numBlocked(0), weightVersion(g.getVersion() + 1), version(0),
+          closureVersion(0) {
+        sync();
+    }
+
+    EdgeCostOverlay(const EdgeCostOverlay&) = delete;
+    EdgeCostOverlay& operator=(const EdgeCostOverlay&) = delete;
+
+    void setBlocked(int e, bool isBlocked) {
+        sync();
+        if (e < 0 || e >= numEdges) return;
+        if (blocked[e] != isBlocked) numBlocked += isBlocked ? 1 : -1;
+        blocked[e] = isBlocked;
+        recompute(e, graph.getSnapshot());
+    }
+
+    // Extra travel time on top of the weight; negative values count as 0
+    void setPenalty(int e, int extra) {
+        sync();
+        if (e < 0 || e >= numEdges) return;
+        penalty[e] = extra > 0 ? extra : 0;
+        recompute(e, graph.getSnapshot());
+    }
+
+    // Applies setBlocked to every edge u -> v
+    void setBlocked(int u, int v, bool isBlocked) {
+        const CSRGraph& csr = graph.getSnapshot();
+        if (u < 0 || u >= csr.getNumVertices()) return;
+        for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); e++) {
+            if (csr.target(e) == v) setBlocked(e, isBlocked);
+        }
+    }
+
+    bool isBlocked(int e) const { return blocked[e]; }
+    bool hasClosures() { sync(); return numBlocked > 0; }
+    int getPenalty(int e) const { return penalty[e]; }
+    int getCost(int e) { sync(); return cost[e]; }
+    int getNumEdges() const { return numEdges; }
+
+    // Costs by edge id, for the searches' edgeCosts parameter
+    const int* getCosts() {
+        sync();
+        return cost.begin();
+    }
+
+    // Changes whenever a cost changes; caches of routes compare it
+    unsigned long getVersion() {
+        sync();
+        return version;
+    }
+
+    // Changes only when a road is closed or reopened, not when its
+    // congestion penalty moves
+    unsigned long getClosureVersion() {
+        sync();
+        return closureVersion;
+    }
+
+    // Moves the ids of edges whose cost changed since the last call into
+    // edges, each once, so a consumer can follow the costs incrementally
+    void takeChangedEdges(DynamicArray<int>& edges) {
+        sync();
+        edges.clear();
+        for (int i = 0; i < (int)changed.size(); i++) {
+            edges.push_back(changed[i]);
+            isChanged[changed[i]] = false;
+        }
+        changed.clear();
+    }
+};
+
+#endif // COST_OVERLAY_H
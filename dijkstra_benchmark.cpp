@@ -0,0 +1,227 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include "graph.h"
+#include "contractionhierarchy.h"
+#include "routeplanner.h"
+
+// Benchmark: heap-based DirectedWeightedGraph::dijkstra, bidirectionalDijkstra,
+// ALT astar, ContractionHierarchy and CustomizableRoutePlanner queries against
+// the previous linear-scan implementation on synthetic grids.
+//
+//   g++ -O2 dijkstra_benchmark.cpp -o dijkstra_benchmark
+//   ./dijkstra_benchmark
+
+using namespace std;
+
+// The O(V^2) search that dijkstra() used before, kept here for comparison
+int linearScanDijkstra(DirectedWeightedGraph& graph, int source, int destination, int path[]) {
+    int numVertices = graph.getNumVertices();
+    int* dist = new int[numVertices];
+    bool* visited = new bool[numVertices];
+    int* prev = new int[numVertices];
+
+    for (int i = 0; i < numVertices; ++i) {
+        dist[i] = INT_MAX;
+        visited[i] = false;
+        prev[i] = -1;
+    }
+    dist[source] = 0;
+
+    for (int i = 0; i < numVertices - 1; ++i) {
+        int minDist = INT_MAX;
+        int u = -1;
+        for (int j = 0; j < numVertices; ++j) {
+            if (!visited[j] && dist[j] < minDist) {
+                minDist = dist[j];
+                u = j;
+            }
+        }
+        if (u == -1) break;
+        visited[u] = true;
+
+        GNode* current = graph.getEdges(u);
+        while (current != nullptr) {
+            int v = current->vertex;
+            if (dist[u] != INT_MAX && dist[u] + current->weight < dist[v]) {
+                dist[v] = dist[u] + current->weight;
+                prev[v] = u;
+            }
+            current = current->next;
+        }
+    }
+
+    int pathIndex = 0;
+    for (int node = destination; node != -1; node = prev[node]) {
+        path[pathIndex++] = node;
+    }
+    for (int i = 0; i < pathIndex / 2; ++i) {
+        int temp = path[i];
+        path[i] = path[pathIndex - i - 1];
+        path[pathIndex - i - 1] = temp;
+    }
+
+    delete[] dist;
+    delete[] visited;
+    delete[] prev;
+    return pathIndex;
+}
+
+// Two-way grid of side x side intersections with travel times in [1, 20]
+DirectedWeightedGraph* buildGrid(int side) {
+    DirectedWeightedGraph* graph = new DirectedWeightedGraph(side * side);
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int u = r * side + c;
+            if (c + 1 < side) {
+                graph->addEdge(u, u + 1, 1 + rand() % 20);
+                graph->addEdge(u + 1, u, 1 + rand() % 20);
+            }
+            if (r + 1 < side) {
+                graph->addEdge(u, u + side, 1 + rand() % 20);
+                graph->addEdge(u + side, u, 1 + rand() % 20);
+            }
+        }
+    }
+    return graph;
+}
+
+int pathCost(DirectedWeightedGraph& graph, const int path[], int length) {
+    int cost = 0;
+    for (int i = 0; i + 1 < length; i++) {
+        GNode* edge = graph.getEdges(path[i]);
+        int best = INT_MAX;
+        while (edge != nullptr) {
+            if (edge->vertex == path[i + 1] && edge->weight < best) best = edge->weight;
+            edge = edge->next;
+        }
+        cost += best;
+    }
+    return cost;
+}
+
+int main() {
+    srand(42);
+    const int targetSizes[] = {1000, 10000, 100000};
+    const int heapQueries[] = {200, 100, 50};
+    const int linearQueries[] = {200, 10, 1};  // O(V^2) gets very slow at 100k
+
+    cout << "Dijkstra benchmark (average time per query)\n";
+    cout << "===========================================\n";
+
+    for (int s = 0; s < 3; s++) {
+        int side = (int)sqrt((double)targetSizes[s]);
+        DirectedWeightedGraph* graph = buildGrid(side);
+        int n = side * side;
+        int* path = new int[n];
+        DynamicArray<int> route;
+
+        int* sources = new int[heapQueries[s]];
+        int* targets = new int[heapQueries[s]];
+        for (int q = 0; q < heapQueries[s]; q++) {
+            sources[q] = rand() % n;
+            targets[q] = rand() % n;
+        }
+
+        auto begin = chrono::steady_clock::now();
+        long long heapChecksum = 0;
+        for (int q = 0; q < heapQueries[s]; q++) {
+            int length = graph->dijkstra(sources[q], targets[q], route);
+            if (q < linearQueries[s]) heapChecksum += pathCost(*graph, route.begin(), length);
+        }
+        double heapMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count()
+                        / heapQueries[s];
+
+        begin = chrono::steady_clock::now();
+        long long bidirectionalChecksum = 0;
+        for (int q = 0; q < heapQueries[s]; q++) {
+            int length = graph->bidirectionalDijkstra(sources[q], targets[q], route);
+            if (q < linearQueries[s]) bidirectionalChecksum += pathCost(*graph, route.begin(), length);
+        }
+        double bidirectionalMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count()
+                                 / heapQueries[s];
+
+        begin = chrono::steady_clock::now();
+        graph->precomputeLandmarks(16);
+        double landmarkMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        begin = chrono::steady_clock::now();
+        long long astarChecksum = 0;
+        for (int q = 0; q < heapQueries[s]; q++) {
+            int length = graph->astar(sources[q], targets[q], route);
+            if (q < linearQueries[s]) astarChecksum += pathCost(*graph, route.begin(), length);
+        }
+        double astarMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count()
+                         / heapQueries[s];
+
+        begin = chrono::steady_clock::now();
+        ContractionHierarchy hierarchy(*graph);
+        double contractionMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        begin = chrono::steady_clock::now();
+        long long hierarchyChecksum = 0;
+        for (int q = 0; q < heapQueries[s]; q++) {
+            int length = hierarchy.query(sources[q], targets[q], route);
+            if (q < linearQueries[s]) hierarchyChecksum += pathCost(*graph, route.begin(), length);
+        }
+        double hierarchyMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count()
+                             / heapQueries[s];
+
+        begin = chrono::steady_clock::now();
+        CustomizableRoutePlanner planner(*graph);
+        double partitionMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        begin = chrono::steady_clock::now();
+        planner.customize(nullptr);
+        double customizeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+
+        begin = chrono::steady_clock::now();
+        long long plannerChecksum = 0;
+        for (int q = 0; q < heapQueries[s]; q++) {
+            int length = planner.query(sources[q], targets[q], route);
+            if (q < linearQueries[s]) plannerChecksum += pathCost(*graph, route.begin(), length);
+        }
+        double plannerMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count()
+                           / heapQueries[s];
+
+        // Closing one road re-customizes only the cells around it
+        const int closures = 20;
+        begin = chrono::steady_clock::now();
+        for (int c = 0; c < closures; c++) {
+            int edge = rand() % graph->getSnapshot().getNumEdges();
+            planner.setEdgeCost(edge, INT_MAX);
+            planner.customize();
+            planner.setEdgeCost(edge, graph->getSnapshot().weight(edge));
+            planner.customize();
+        }
+        double closureMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count()
+                           / (2 * closures);
+
+        begin = chrono::steady_clock::now();
+        long long linearChecksum = 0;
+        for (int q = 0; q < linearQueries[s]; q++) {
+            int length = linearScanDijkstra(*graph, sources[q], targets[q], path);
+            linearChecksum += pathCost(*graph, path, length);
+        }
+        double linearMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count()
+                          / linearQueries[s];
+
+        cout << n << " nodes: linear scan " << linearMs << " ms, heap " << heapMs
+             << " ms, bidirectional " << bidirectionalMs << " ms, ALT " << astarMs
+             << " ms (landmarks " << landmarkMs << " ms once), CH " << hierarchyMs
+             << " ms (contraction " << contractionMs << " ms once), CRP " << plannerMs
+             << " ms (partition " << partitionMs << " ms once, customize " << customizeMs
+             << " ms, " << closureMs << " ms per road cost change)"
+             << (heapChecksum == linearChecksum && bidirectionalChecksum == linearChecksum &&
+                 astarChecksum == linearChecksum && hierarchyChecksum == linearChecksum &&
+                 plannerChecksum == linearChecksum
+                     ? "" : "  (ROUTE COSTS DIFFER!)") << endl;
+
+        delete[] sources;
+        delete[] targets;
+        delete[] path;
+        delete graph;
+    }
+    return 0;
+}
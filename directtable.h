@@ -0,0 +1,175 @@
+#ifndef DIRECT_TABLE_H
+#define DIRECT_TABLE_H
+
+#include <iostream>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Table for small, dense, non-negative integral keys such as intersection
+// ids, with the same interface as HashTable. The key is the index into a
+// flat value array and a presence bitmap records which keys are stored, so
+// get / insert / remove are one indexed load or store with no hashing.
+// The arrays grow to the largest key inserted; negative keys are never
+// stored (get and remove report them as missing).
+template<typename K, typename V>
+class DirectTable {
+    static_assert(std::is_integral<K>::value, "DirectTable keys must be integral");
+
+private:
+    static const size_t DEFAULT_CAPACITY = 64;
+
+    V* values;
+    uint64_t* present;   // bit k set when key k is stored
+    size_t capacity;     // multiple of 64
+    size_t size;
+
+    bool has(size_t index) const {
+        return (present[index >> 6] >> (index & 63)) & 1;
+    }
+
+    bool inRange(const K& key) const {
+        return key >= 0 && (size_t)key < capacity;
+    }
+
+    void grow(size_t minCapacity) {
+        size_t newCapacity = capacity;
+        while (newCapacity < minCapacity) newCapacity *= 2;
+
+        V* newValues = new V[newCapacity];
+        uint64_t* newPresent = new uint64_t[newCapacity / 64]();
+        for (size_t i = 0; i < capacity; i++) {
+            if (has(i)) newValues[i] = values[i];
+        }
+        for (size_t w = 0; w < capacity / 64; w++) newPresent[w] = present[w];
+
+        delete[] values;
+        delete[] present;
+        values = newValues;
+        present = newPresent;
+        capacity = newCapacity;
+    }
+
+    // Marks key present (growing if needed) and returns its slot
+    V& slot(const K& key) {
+        size_t index = (size_t)key;
+        if (index >= capacity) grow(index + 1);
+        if (!has(index)) {
+            present[index >> 6] |= (uint64_t)1 << (index & 63);
+            values[index] = V();
+            size++;
+        }
+        return values[index];
+    }
+
+public:
+    explicit DirectTable(size_t initialCapacity = DEFAULT_CAPACITY)
+        : capacity(((initialCapacity > 0 ? initialCapacity : 1) + 63) / 64 * 64), size(0) {
+        values = new V[capacity];
+        present = new uint64_t[capacity / 64]();
+    }
+
+    ~DirectTable() {
+        delete[] values;
+        delete[] present;
+    }
+
+    DirectTable(const DirectTable&) = delete;
+    DirectTable& operator=(const DirectTable&) = delete;
+
+    void insert(const K& key, const V& value) {
+        if (key < 0) return;
+        slot(key) = value;
+    }
+
+    void insert(const K& key, V&& value) {
+        if (key < 0) return;
+        slot(key) = std::move(value);
+    }
+
+    // Constructs the value from args if key is absent. Returns the entry's
+    // value and whether it was inserted. Key must be non-negative.
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+        size_t index = (size_t)key;
+        if (index < capacity && has(index)) return std::make_pair(&values[index], false);
+        V& value = slot(key);
+        value = V(std::forward<Args>(args)...);
+        return std::make_pair(&value, true);
+    }
+
+    // Value stored under key, or nullptr. Valid until the table grows.
+    V* find(const K& key) {
+        return inRange(key) && has((size_t)key) ? &values[(size_t)key] : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        return inRange(key) && has((size_t)key) ? &values[(size_t)key] : nullptr;
+    }
+
+    bool remove(const K& key) {
+        if (!inRange(key) || !has((size_t)key)) return false;
+        size_t index = (size_t)key;
+        present[index >> 6] &= ~((uint64_t)1 << (index & 63));
+        values[index] = V();
+        size--;
+        return true;
+    }
+
+    bool get(const K& key, V& value) const {
+        if (!inRange(key) || !has((size_t)key)) return false;
+        value = values[(size_t)key];
+        return true;
+    }
+
+    // Key must be non-negative
+    V& operator[](const K& key) {
+        return slot(key);
+    }
+
+    // Calls visit(key, value) once per entry, in key order. visit must not
+    // insert into or remove from the table.
+    template<typename F>
+    void forEach(F visit) {
+        for (size_t w = 0; w < capacity / 64; w++) {
+            if (present[w] == 0) continue;       // skip 64 absent keys at once
+            for (size_t index = w * 64; index < w * 64 + 64; index++) {
+                if (has(index)) visit((K)index, values[index]);
+            }
+        }
+    }
+
+    template<typename F>
+    void forEach(F visit) const {
+        for (size_t w = 0; w < capacity / 64; w++) {
+            if (present[w] == 0) continue;       // skip 64 absent keys at once
+            for (size_t index = w * 64; index < w * 64 + 64; index++) {
+                if (has(index)) visit((K)index, (const V&)values[index]);
+            }
+        }
+    }
+
+    void clear() {
+        for (size_t w = 0; w < capacity / 64; w++) {
+            if (present[w] == 0) continue;
+            for (size_t index = w * 64; index < w * 64 + 64; index++) {
+                if (has(index)) values[index] = V();
+            }
+            present[w] = 0;
+        }
+        size = 0;
+    }
+
+    size_t getSize() const { return size; }
+    size_t getCapacity() const { return capacity; }
+    bool isEmpty() const { return size == 0; }
+
+    // For debugging
+    void print() const {
+        forEach([](const K& key, const V& value) {
+            std::cout << "[" << key << "]: " << value << std::endl;
+        });
+    }
+};
+
+#endif // DIRECT_TABLE_H
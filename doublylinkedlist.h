@@ -209,14 +209,20 @@ class LinkedList {
         }
     }
 
-    void countNodes() {
+    int countNodes() const {
         Node<T>* p = head;
         int count = 0;
         while (p != NULL) {
             count++;
             p = p->next;
         }
-        cout << "Linked list has: " << count << " nodes\n";
+        return count;
+    }
+
+    void clear() {
+        while (head != NULL) {
+            deleteAtStart();
+        }
     }
 };
 
@@ -0,0 +1,131 @@
+#ifndef DYNAMIC_ARRAY_H
+#define DYNAMIC_ARRAY_H
+
+#include <cstddef>
+#include <utility>
+
+// Growable contiguous array. Capacity doubles when full and is kept across
+// clear(), so a reused array stops allocating once it reaches its peak size.
+template <typename T>
+class DynamicArray {
+private:
+    T* data;
+    size_t count;
+    size_t capacity;
+
+    void grow(size_t minCapacity) {
+        size_t newCapacity = capacity == 0 ? 8 : capacity;
+        while (newCapacity < minCapacity) {
+            newCapacity *= 2;
+        }
+        T* newData = new T[newCapacity];
+        for (size_t i = 0; i < count; i++) {
+            newData[i] = std::move(data[i]);
+        }
+        delete[] data;
+        data = newData;
+        capacity = newCapacity;
+    }
+
+public:
+    DynamicArray() : data(nullptr), count(0), capacity(0) {}
+
+    explicit DynamicArray(size_t n, const T& value = T()) : data(nullptr), count(0), capacity(0) {
+        resize(n, value);
+    }
+
+    DynamicArray(const DynamicArray& other) : data(nullptr), count(0), capacity(0) {
+        reserve(other.count);
+        for (size_t i = 0; i < other.count; i++) {
+            data[i] = other.data[i];
+        }
+        count = other.count;
+    }
+
+    DynamicArray(DynamicArray&& other) noexcept
+        : data(other.data), count(other.count), capacity(other.capacity) {
+        other.data = nullptr;
+        other.count = 0;
+        other.capacity = 0;
+    }
+
+    DynamicArray& operator=(const DynamicArray& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.count);
+            for (size_t i = 0; i < other.count; i++) {
+                data[i] = other.data[i];
+            }
+            count = other.count;
+        }
+        return *this;
+    }
+
+    DynamicArray& operator=(DynamicArray&& other) noexcept {
+        if (this != &other) {
+            delete[] data;
+            data = other.data;
+            count = other.count;
+            capacity = other.capacity;
+            other.data = nullptr;
+            other.count = 0;
+            other.capacity = 0;
+        }
+        return *this;
+    }
+
+    ~DynamicArray() {
+        delete[] data;
+    }
+
+    void push_back(const T& value) {
+        if (count == capacity) {
+            grow(count + 1);
+        }
+        data[count++] = value;
+    }
+
+    void pop_back() {
+        if (count > 0) count--;
+    }
+
+    void reserve(size_t n) {
+        if (n > capacity) {
+            grow(n);
+        }
+    }
+
+    // New slots are set to value; shrinking keeps the capacity
+    void resize(size_t n, const T& value = T()) {
+        reserve(n);
+        for (size_t i = count; i < n; i++) {
+            data[i] = value;
+        }
+        count = n;
+    }
+
+    void reverse() {
+        for (size_t i = 0; i < count / 2; i++) {
+            std::swap(data[i], data[count - i - 1]);
+        }
+    }
+
+    void clear() { count = 0; }
+
+    T& operator[](size_t index) { return data[index]; }
+    const T& operator[](size_t index) const { return data[index]; }
+
+    T& back() { return data[count - 1]; }
+    const T& back() const { return data[count - 1]; }
+
+    T* begin() { return data; }
+    T* end() { return data + count; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + count; }
+
+    size_t size() const { return count; }
+    size_t getCapacity() const { return capacity; }
+    bool empty() const { return count == 0; }
+};
+
+#endif // DYNAMIC_ARRAY_H
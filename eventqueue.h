@@ -0,0 +1,159 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <climits>
+#include <cstddef>
+#include "dynamicarray.h"
+#include "simclock.h"
+
+// Pending events of a discrete-event simulation, keyed by whole simulated
+// seconds. Events due within the next WHEEL_SIZE seconds sit in a timing
+// wheel, one bucket per second, so scheduling and popping them is O(1);
+// later ones wait in a binary heap and move into the wheel as their second
+// comes into range. Events due at the same second come out in the order
+// they were scheduled, so a run is deterministic.
+//
+// The queue keeps time on the SimClock it is given. Time only moves
+// forward: pop() advances the clock to each event it returns, and to
+// `until` once nothing more is due. When the wheel is empty it jumps
+// straight to the next event in the heap instead of stepping through the
+// idle seconds.
+template<typename T>
+class EventQueue {
+private:
+    struct Entry {
+        long time;
+        unsigned long sequence;     // scheduling order, breaks ties in the heap
+        T event;
+    };
+
+    static const size_t WHEEL_SIZE = 256;           // power of two
+    static const size_t WHEEL_MASK = WHEEL_SIZE - 1;
+
+    DynamicArray<Entry> wheel[WHEEL_SIZE];          // bucket t & WHEEL_MASK holds second t
+    DynamicArray<Entry> later;                      // min-heap on (time, sequence)
+    SimClock& clock;                                // second being processed
+    size_t consumed;                                // events of the current bucket already popped
+    size_t inWheel;
+    unsigned long nextSequence;
+
+    static bool before(const Entry& a, const Entry& b) {
+        return a.time < b.time || (a.time == b.time && a.sequence < b.sequence);
+    }
+
+    void pushLater(const Entry& entry) {
+        later.push_back(entry);
+        size_t i = later.size() - 1;
+        while (i > 0 && before(later[i], later[(i - 1) / 2])) {
+            std::swap(later[i], later[(i - 1) / 2]);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void popLater() {
+        later[0] = later.back();
+        later.pop_back();
+        size_t i = 0;
+        while (true) {
+            size_t smallest = i;
+            size_t left = 2 * i + 1, right = 2 * i + 2;
+            if (left < later.size() && before(later[left], later[smallest])) smallest = left;
+            if (right < later.size() && before(later[right], later[smallest])) smallest = right;
+            if (smallest == i) break;
+            std::swap(later[i], later[smallest]);
+            i = smallest;
+        }
+    }
+
+    // Moves heap events that now fall inside the wheel's window into it,
+    // earliest first, so they precede anything scheduled for the same second
+    void pullIntoWheel() {
+        long horizon = clock.now() + (long)WHEEL_SIZE;
+        while (!later.empty() && later[0].time < horizon) {
+            wheel[later[0].time & WHEEL_MASK].push_back(later[0]);
+            inWheel++;
+            popLater();
+        }
+    }
+
+public:
+    explicit EventQueue(SimClock& c) : clock(c), consumed(0), inWheel(0), nextSequence(0) {}
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    // Current simulated second; safe to read from other threads
+    long now() const { return clock.now(); }
+
+    const SimClock& getClock() const { return clock; }
+
+    // Schedules event for second time (now() if time is already past)
+    void schedule(long time, const T& event) {
+        long t = clock.now();
+        if (time < t) time = t;
+        Entry entry{time, nextSequence++, event};
+        if (time < t + (long)WHEEL_SIZE) {
+            wheel[time & WHEEL_MASK].push_back(entry);
+            inWheel++;
+        } else {
+            pushLater(entry);
+        }
+    }
+
+    void scheduleIn(long delay, const T& event) {
+        schedule(now() + delay, event);
+    }
+
+    // Pops the next event due at or before until into event and advances
+    // now() to its time. Returns false, with now() == until, once none is due.
+    bool pop(long until, T& event) {
+        while (true) {
+            long t = clock.now();
+            DynamicArray<Entry>& bucket = wheel[t & WHEEL_MASK];
+            if (consumed < bucket.size()) {
+                event = bucket[consumed++].event;
+                inWheel--;
+                return true;
+            }
+            bucket.clear();
+            consumed = 0;
+            if (t >= until) return false;
+
+            long next = t + 1;
+            if (inWheel == 0) {                     // skip idle seconds
+                next = later.empty() || later[0].time > until ? until : later[0].time;
+            }
+            clock.advanceTo(next);
+            pullIntoWheel();
+        }
+    }
+
+    // Pops the next event due at now() into event if accept(event) holds,
+    // without moving time. Lets the caller take a run of events from the
+    // current second as one batch.
+    template<typename F>
+    bool popNextIf(F accept, T& event) {
+        DynamicArray<Entry>& bucket = wheel[clock.now() & WHEEL_MASK];
+        if (consumed >= bucket.size() || !accept(bucket[consumed].event)) return false;
+        event = bucket[consumed++].event;
+        inWheel--;
+        return true;
+    }
+
+    // Second of the earliest pending event, or LONG_MAX if there is none
+    long nextTime() const {
+        long t = clock.now();
+        if (inWheel > 0) {
+            if (consumed < wheel[t & WHEEL_MASK].size()) return t;
+            for (size_t i = 1; i < WHEEL_SIZE; i++) {
+                if (!wheel[(t + i) & WHEEL_MASK].empty()) return t + (long)i;
+            }
+        }
+        return later.empty() ? LONG_MAX : later[0].time;
+    }
+
+    size_t size() const { return inWheel + later.size(); }
+    bool empty() const { return size() == 0; }
+};
+
+#endif // EVENT_QUEUE_H
@@ -0,0 +1,260 @@
+#ifndef FLAT_HASH_TABLE_H
+#define FLAT_HASH_TABLE_H
+
+#include <iostream>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+// Open-addressing replacement for HashTable with the same insert / get /
+// remove / operator[] interface. Entries live in one contiguous slot array
+// (power-of-two sized) and collisions are resolved with Robin Hood linear
+// probing: an entry that has travelled further from its home slot takes the
+// place of one that has travelled less, which keeps probe sequences short
+// and lets a lookup stop as soon as it passes where the key would have been.
+// Removal shifts the following entries back instead of leaving tombstones.
+//
+// Probing reads a separate array of 8-byte probe records (distance and the
+// upper hash bits), so it never touches the entries themselves and only
+// compares keys whose hash bits match.
+//
+// Keys and values must be default constructible; slots hold them in place.
+template<typename K, typename V>
+class FlatHashTable {
+private:
+    struct Slot {
+        K key;
+        V value;
+    };
+
+    struct Probe {
+        int32_t distance;   // probes from the home slot, -1 if empty
+        uint32_t hash;      // upper hash bits, checked before the key
+    };
+
+    static const size_t DEFAULT_CAPACITY = 16;
+    static const size_t MAX_LOAD_PERCENT = 80;
+
+    Slot* slots;
+    Probe* probes;      // parallel to slots
+    size_t capacity;    // always a power of two
+    size_t mask;
+    size_t size;
+
+    // Fibonacci hashing spreads std::hash results that are the identity
+    // (integers) over the high bits; the home slot is taken from those bits
+    static uint32_t hashOf(const K& key) {
+        uint64_t h = (uint64_t)std::hash<K>{}(key) * 0x9E3779B97F4A7C15ull;
+        return (uint32_t)(h >> 32);
+    }
+
+    static size_t roundUp(size_t n) {
+        size_t c = DEFAULT_CAPACITY;
+        while (c < n) c *= 2;
+        return c;
+    }
+
+    // Slot index holding key, or -1
+    long find(const K& key, uint32_t hash) const {
+        size_t index = hash & mask;
+        for (int32_t distance = 0; ; distance++) {
+            const Probe& probe = probes[index];
+            if (probe.distance < distance) return -1;   // empty, or key would have displaced it
+            if (probe.hash == hash && slots[index].key == key) return (long)index;
+            index = (index + 1) & mask;
+        }
+    }
+
+    // Places a key known to be absent; returns the slot it ended up in
+    size_t place(K key, V value, uint32_t hash) {
+        size_t index = hash & mask;
+        Probe incoming{0, hash};
+        long placed = -1;
+        while (true) {
+            Probe& probe = probes[index];
+            if (probe.distance == -1) {
+                slots[index].key = std::move(key);
+                slots[index].value = std::move(value);
+                probe = incoming;
+                size++;
+                return placed == -1 ? index : (size_t)placed;
+            }
+            if (probe.distance < incoming.distance) {
+                std::swap(slots[index].key, key);
+                std::swap(slots[index].value, value);
+                std::swap(probe, incoming);
+                if (placed == -1) placed = (long)index;
+            }
+            index = (index + 1) & mask;
+            incoming.distance++;
+        }
+    }
+
+    void rehash(size_t newCapacity) {
+        Slot* oldSlots = slots;
+        Probe* oldProbes = probes;
+        size_t oldCapacity = capacity;
+
+        capacity = newCapacity;
+        mask = capacity - 1;
+        allocate();
+
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldProbes[i].distance != -1) {
+                place(std::move(oldSlots[i].key), std::move(oldSlots[i].value), oldProbes[i].hash);
+            }
+        }
+        delete[] oldSlots;
+        delete[] oldProbes;
+    }
+
+    void allocate() {
+        slots = new Slot[capacity];
+        probes = new Probe[capacity];
+        for (size_t i = 0; i < capacity; i++) probes[i].distance = -1;
+        size = 0;
+    }
+
+    void growIfFull() {
+        if ((size + 1) * 100 > capacity * MAX_LOAD_PERCENT) {
+            rehash(capacity * 2);
+        }
+    }
+
+public:
+    explicit FlatHashTable(size_t initialCapacity = DEFAULT_CAPACITY)
+        : capacity(roundUp(initialCapacity)), size(0) {
+        mask = capacity - 1;
+        allocate();
+    }
+
+    ~FlatHashTable() {
+        delete[] slots;
+        delete[] probes;
+    }
+
+    FlatHashTable(const FlatHashTable&) = delete;
+    FlatHashTable& operator=(const FlatHashTable&) = delete;
+
+    // Grows the slot array so n entries fit without rehashing
+    void reserve(size_t n) {
+        size_t needed = capacity;
+        while (n * 100 > needed * MAX_LOAD_PERCENT) needed *= 2;
+        if (needed > capacity) rehash(needed);
+    }
+
+    void insert(const K& key, const V& value) {
+        std::pair<V*, bool> result = try_emplace(key, value);
+        if (!result.second) *result.first = value;
+    }
+
+    void insert(const K& key, V&& value) {
+        std::pair<V*, bool> result = try_emplace(key, std::move(value));
+        if (!result.second) *result.first = std::move(value);
+    }
+
+    // Constructs the value from args if key is absent. Returns the entry's
+    // value and whether it was inserted; an existing value is left as is.
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+        uint32_t hash = hashOf(key);
+        long index = find(key, hash);
+        if (index != -1) return std::make_pair(&slots[index].value, false);
+        growIfFull();
+        size_t placed = place(key, V(std::forward<Args>(args)...), hash);
+        return std::make_pair(&slots[placed].value, true);
+    }
+
+    // Value stored under key, or nullptr. Valid until the table is
+    // next modified (entries move when others are inserted or removed).
+    V* find(const K& key) {
+        long index = find(key, hashOf(key));
+        return index == -1 ? nullptr : &slots[index].value;
+    }
+
+    const V* find(const K& key) const {
+        long index = find(key, hashOf(key));
+        return index == -1 ? nullptr : &slots[index].value;
+    }
+
+    bool remove(const K& key) {
+        long found = find(key, hashOf(key));
+        if (found == -1) return false;
+
+        // Backward shift: pull later entries of the run one slot closer home
+        size_t index = (size_t)found;
+        size_t next = (index + 1) & mask;
+        while (probes[next].distance > 0) {
+            slots[index].key = std::move(slots[next].key);
+            slots[index].value = std::move(slots[next].value);
+            probes[index].distance = probes[next].distance - 1;
+            probes[index].hash = probes[next].hash;
+            index = next;
+            next = (next + 1) & mask;
+        }
+        slots[index].key = K();
+        slots[index].value = V();
+        probes[index].distance = -1;
+        size--;
+        return true;
+    }
+
+    bool get(const K& key, V& value) const {
+        long index = find(key, hashOf(key));
+        if (index == -1) return false;
+        value = slots[index].value;
+        return true;
+    }
+
+    // Inserts a default value if key is absent
+    V& operator[](const K& key) {
+        return *try_emplace(key).first;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < capacity; i++) {
+            if (probes[i].distance != -1) {
+                slots[i].key = K();
+                slots[i].value = V();
+                probes[i].distance = -1;
+            }
+        }
+        size = 0;
+    }
+
+    // Calls visit(key, value) once per entry, in slot order. visit must
+    // not insert into or remove from the table.
+    template<typename F>
+    void forEach(F visit) {
+        for (size_t i = 0; i < capacity; i++) {
+            if (probes[i].distance != -1) visit(slots[i].key, slots[i].value);
+        }
+    }
+
+    template<typename F>
+    void forEach(F visit) const {
+        for (size_t i = 0; i < capacity; i++) {
+            if (probes[i].distance != -1) visit(slots[i].key, slots[i].value);
+        }
+    }
+
+    size_t getSize() const { return size; }
+    size_t getCapacity() const { return capacity; }
+    bool isEmpty() const { return size == 0; }
+
+    // For debugging
+    void print() const {
+        for (size_t i = 0; i < capacity; i++) {
+            std::cout << "[" << i << "]: ";
+            if (probes[i].distance == -1) {
+                std::cout << "null";
+            } else {
+                std::cout << "(" << slots[i].key << ":" << slots[i].value
+                          << ", +" << probes[i].distance << ")";
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+
+#endif // FLAT_HASH_TABLE_H
@@ -2,6 +2,9 @@
 #define GRAPH_H
 #include <iostream>
 #include <climits>
+#include "heap.h"
+#include "dynamicarray.h"
+#include "searchworkspace.h"
 
 using namespace std;
 
@@ -15,16 +18,176 @@ public:
     GNode(int v, int w) : vertex(v), weight(w), next(nullptr) {}
 };
 
+// Immutable compressed-sparse-row snapshot of the road network.
+// The outgoing edges of u are the ids offsets[u] .. offsets[u + 1] - 1 and
+// live contiguously in targets[] / weights[], so traversals walk arrays
+// instead of chasing one heap node per edge. The incoming edges of v are
+// indexed the same way (reverseBegin/reverseEnd) for backward searches.
+class CSRGraph {
+private:
+    int numVertices;
+    int numEdges;
+    int* offsets;   // numVertices + 1 entries
+    int* targets;   // numEdges entries
+    int* weights;   // numEdges entries
+    int* reverseOffsets;  // numVertices + 1 entries
+    int* reverseEdges;    // ids of the edges entering each vertex
+    int* sources;         // sources[e] = tail of edge e
+
+public:
+    CSRGraph(int n, GNode** adjacencyList) : numVertices(n), numEdges(0) {
+        offsets = new int[numVertices + 1];
+        offsets[0] = 0;
+        for (int u = 0; u < numVertices; ++u) {
+            int degree = 0;
+            for (GNode* current = adjacencyList[u]; current != nullptr; current = current->next) {
+                degree++;
+            }
+            offsets[u + 1] = offsets[u] + degree;
+        }
+        numEdges = offsets[numVertices];
+
+        targets = new int[numEdges];
+        weights = new int[numEdges];
+        for (int u = 0; u < numVertices; ++u) {
+            int e = offsets[u];
+            for (GNode* current = adjacencyList[u]; current != nullptr; current = current->next) {
+                targets[e] = current->vertex;
+                weights[e] = current->weight;
+                e++;
+            }
+        }
+
+        // Bucket the edge ids by target for the reverse (incoming) adjacency
+        reverseOffsets = new int[numVertices + 1]();
+        for (int e = 0; e < numEdges; ++e) {
+            reverseOffsets[targets[e] + 1]++;
+        }
+        for (int v = 0; v < numVertices; ++v) {
+            reverseOffsets[v + 1] += reverseOffsets[v];
+        }
+        reverseEdges = new int[numEdges];
+        int* fill = new int[numVertices];
+        for (int v = 0; v < numVertices; ++v) {
+            fill[v] = reverseOffsets[v];
+        }
+        for (int u = 0; u < numVertices; ++u) {
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                reverseEdges[fill[targets[e]]++] = e;
+            }
+        }
+        delete[] fill;
+
+        sources = new int[numEdges];
+        for (int u = 0; u < numVertices; ++u) {
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                sources[e] = u;
+            }
+        }
+    }
+
+    ~CSRGraph() {
+        delete[] offsets;
+        delete[] targets;
+        delete[] weights;
+        delete[] reverseOffsets;
+        delete[] reverseEdges;
+        delete[] sources;
+    }
+
+    CSRGraph(const CSRGraph&) = delete;
+    CSRGraph& operator=(const CSRGraph&) = delete;
+
+    int getNumVertices() const { return numVertices; }
+    int getNumEdges() const { return numEdges; }
+
+    // Edge ids of u's outgoing edges are [edgeBegin(u), edgeEnd(u))
+    int edgeBegin(int u) const { return offsets[u]; }
+    int edgeEnd(int u) const { return offsets[u + 1]; }
+    int target(int e) const { return targets[e]; }
+    int weight(int e) const { return weights[e]; }
+    int source(int e) const { return sources[e]; }
+
+    // Positions [reverseBegin(v), reverseEnd(v)) of reverseEdge() hold the
+    // ids of the edges that end at v
+    int reverseBegin(int v) const { return reverseOffsets[v]; }
+    int reverseEnd(int v) const { return reverseOffsets[v + 1]; }
+    int reverseEdge(int i) const { return reverseEdges[i]; }
+
+    // Returns the id of the edge u -> v, or -1 if there is none
+    int findEdge(int u, int v) const {
+        if (u < 0 || u >= numVertices) return -1;
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            if (targets[e] == v) return e;
+        }
+        return -1;
+    }
+
+    // Weight of u -> v, or -1 if there is no such edge
+    int edgeWeight(int u, int v) const {
+        int e = findEdge(u, v);
+        return e == -1 ? -1 : weights[e];
+    }
+
+    // Weight changes keep the topology, so they are patched in place
+    void setWeight(int e, int w) { weights[e] = w; }
+};
+
 // Directed, Weighted Graph Class
 class DirectedWeightedGraph {
 private:
     int numVertices;
     GNode** adjacencyList;  // Array of adjacency lists (one for each vertex)
+    CSRGraph* snapshot;     // Read-only CSR copy used by all traversals
+    bool topologyChanged;   // Snapshot must be rebuilt before the next read
+    unsigned long version;  // Bumped on every topology or weight change
+
+    // ALT landmark tables: fromLandmark[i * numVertices + v] = d(landmark i, v)
+    // and toLandmark[i * numVertices + v] = d(v, landmark i), INT_MAX if unreachable
+    int numLandmarks;
+    int* landmarks;
+    int* fromLandmark;
+    int* toLandmark;
+    bool landmarksValid;    // Cleared by changes that could shorten a route
+
+    // Full single-source search (over incoming edges if reverse) into out[]
+    void distancesFrom(int source, bool reverse, int* out) {
+        const CSRGraph& csr = getSnapshot();
+        SearchWorkspace& workspace = SearchWorkspace::forThisThread();
+        workspace.begin(numVertices);
+        workspace.setDistance(source, 0, -1);
+        workspace.queue.push(source, 0);
+
+        while (!workspace.queue.empty()) {
+            int u = workspace.queue.pop();
+            workspace.settle(u);
+            int distU = workspace.distance(u);
+            int begin = reverse ? csr.reverseBegin(u) : csr.edgeBegin(u);
+            int end = reverse ? csr.reverseEnd(u) : csr.edgeEnd(u);
+            for (int i = begin; i < end; ++i) {
+                int e = reverse ? csr.reverseEdge(i) : i;
+                int v = reverse ? csr.source(e) : csr.target(e);
+                int newDist = distU + csr.weight(e);
+                if (!workspace.isSettled(v) && newDist < workspace.distance(v)) {
+                    workspace.setDistance(v, newDist, u);
+                    workspace.queue.pushOrDecrease(v, newDist);
+                }
+            }
+        }
+
+        for (int v = 0; v < numVertices; ++v) {
+            out[v] = workspace.distance(v);
+        }
+    }
+
 
 public:
-    DirectedWeightedGraph(int n) {
-        numVertices = n;
-        adjacencyList = new GNode*[numVertices]; // Allocate memory for each vertex's adjacency list
+    DirectedWeightedGraph(int n)
+        : snapshot(nullptr), topologyChanged(true), version(0), numLandmarks(0), landmarks(nullptr),
+          fromLandmark(nullptr), toLandmark(nullptr), landmarksValid(false) {
+        numVertices = n > 0 ? n : 0;
+        // Allocate memory for each vertex's adjacency list (none for an empty graph)
+        adjacencyList = numVertices > 0 ? new GNode*[numVertices] : nullptr;
 
         for (int i = 0; i < numVertices; ++i) {
             adjacencyList[i] = nullptr;  // Initialize adjacency list for each vertex
@@ -41,6 +204,10 @@ public:
             }
         }
         delete[] adjacencyList;
+        delete snapshot;
+        delete[] landmarks;
+        delete[] fromLandmark;
+        delete[] toLandmark;
     }
 
     // Function to add a directed, weighted edge from u to v with weight w
@@ -48,6 +215,112 @@ public:
         GNode* newNode = new GNode(v, weight);
         newNode->next = adjacencyList[u];
         adjacencyList[u] = newNode;
+        topologyChanged = true;
+        landmarksValid = false;
+        version++;
+    }
+
+    // Changes the weight of the edge u -> v; the snapshot is patched, not rebuilt
+    bool updateEdgeWeight(int u, int v, int weight) {
+        GNode* current = getEdges(u);
+        while (current != nullptr && current->vertex != v) {
+            current = current->next;
+        }
+        if (current == nullptr) return false;
+        // Landmark bounds survive increases (closures, congestion) but not decreases
+        if (weight < current->weight) {
+            landmarksValid = false;
+        }
+        current->weight = weight;
+        version++;
+        if (!topologyChanged && snapshot != nullptr) {
+            snapshot->setWeight(snapshot->findEdge(u, v), weight);
+        }
+        return true;
+    }
+
+    // A separate CSR copy of the current roads, owned by the caller, for
+    // work on another thread while this graph keeps changing
+    CSRGraph* copySnapshot() const {
+        return new CSRGraph(numVertices, adjacencyList);
+    }
+
+    // Returns the CSR snapshot, rebuilding it only if edges were added since
+    // the last build. Call once after loading so readers never trigger a build.
+    const CSRGraph& getSnapshot() {
+        if (topologyChanged || snapshot == nullptr) {
+            delete snapshot;
+            snapshot = new CSRGraph(numVertices, adjacencyList);
+            topologyChanged = false;
+        }
+        return *snapshot;
+    }
+
+    // Picks count landmarks by farthest-point selection and stores the
+    // distances from and to each of them. Run once after the network is loaded,
+    // and again after any edge gets cheaper or is added.
+    void precomputeLandmarks(int count) {
+        if (count > numVertices) count = numVertices;
+        delete[] landmarks;
+        delete[] fromLandmark;
+        delete[] toLandmark;
+        numLandmarks = 0;
+        landmarks = new int[count > 0 ? count : 1];
+        fromLandmark = new int[(size_t)(count > 0 ? count : 1) * numVertices];
+        toLandmark = new int[(size_t)(count > 0 ? count : 1) * numVertices];
+
+        // closest[v] = distance from v to its nearest chosen landmark
+        int* closest = new int[numVertices];
+        for (int v = 0; v < numVertices; ++v) {
+            closest[v] = INT_MAX;
+        }
+
+        int next = 0;
+        while (numLandmarks < count) {
+            landmarks[numLandmarks] = next;
+            int* from = fromLandmark + (size_t)numLandmarks * numVertices;
+            distancesFrom(next, false, from);
+            distancesFrom(next, true, toLandmark + (size_t)numLandmarks * numVertices);
+            numLandmarks++;
+
+            // Next landmark: the reachable vertex farthest from all chosen ones,
+            // or a vertex none of them reach yet
+            int farthest = -1;
+            int farthestDist = -1;
+            for (int v = 0; v < numVertices; ++v) {
+                if (from[v] < closest[v]) closest[v] = from[v];
+                if (closest[v] != 0 && closest[v] > farthestDist) {
+                    farthestDist = closest[v];
+                    farthest = v;
+                }
+            }
+            if (farthest == -1) break;
+            next = farthest;
+        }
+
+        delete[] closest;
+        landmarksValid = true;
+    }
+
+    bool hasLandmarks() const { return landmarksValid && numLandmarks > 0; }
+
+    // Triangle-inequality lower bound on d(v, target) over all landmarks;
+    // only meaningful while hasLandmarks()
+    int landmarkBound(int v, int target) const {
+        int bound = 0;
+        for (int i = 0; i < numLandmarks; ++i) {
+            const int* from = fromLandmark + (size_t)i * numVertices;
+            const int* to = toLandmark + (size_t)i * numVertices;
+            // d(L, t) - d(L, v) <= d(v, t)
+            if (from[target] != INT_MAX && from[v] != INT_MAX && from[target] - from[v] > bound) {
+                bound = from[target] - from[v];
+            }
+            // d(v, L) - d(t, L) <= d(v, t)
+            if (to[v] != INT_MAX && to[target] != INT_MAX && to[v] - to[target] > bound) {
+                bound = to[v] - to[target];
+            }
+        }
+        return bound;
     }
 
     // Function to display the graph's adjacency list
@@ -64,75 +337,198 @@ public:
         }
     }
 
-    // Dijkstra's algorithm to find shortest paths from a source vertex
- // Dijkstra's algorithm to find shortest paths from a source vertex
-int dijkstra(int source, int destination, int path[]) {
-    int* dist = new int[numVertices];  // Array to store the shortest distance from source to each vertex
-    bool* visited = new bool[numVertices]; // Array to track visited vertices
-    int* prev = new int[numVertices]; // Array to store previous vertex for path reconstruction
-
-    // Initialize distances, visited array, and prev array
-    for (int i = 0; i < numVertices; ++i) {
-        dist[i] = INT_MAX;  // Set all distances to infinity
-        visited[i] = false; // Mark all vertices as unvisited
-        prev[i] = -1;       // No previous vertex initially
+    // Returns the head of the adjacency list for vertex u
+    GNode* getEdges(int u) const {
+        if (u < 0 || u >= numVertices) return nullptr;
+        return adjacencyList[u];
     }
-    dist[source] = 0;  // Distance to source is 0
 
-    // Dijkstra's algorithm loop
-    for (int i = 0; i < numVertices - 1; ++i) {
-        // Find the vertex with the smallest distance that has not been visited
-        int minDist = INT_MAX;
-        int u = -1;
-        for (int j = 0; j < numVertices; ++j) {
-            if (!visited[j] && dist[j] < minDist) {
-                minDist = dist[j];
-                u = j;
+    int getNumVertices() const { return numVertices; }
+
+    // Changes whenever an edge is added or reweighted; preprocessed data
+    // (e.g. a ContractionHierarchy) compares it to know when it is stale
+    unsigned long getVersion() const { return version; }
+
+    // Dijkstra's algorithm to find the shortest path from source to destination.
+    // Uses an indexed binary heap with decrease-key, so a query costs
+    // O((V + E) log V), and stops as soon as the destination is settled.
+    // The vertices of the route are written to path; returns how many there
+    // are, or 0 if the destination cannot be reached.
+    // edgeCosts, if given, replaces the weights by edge id (see
+    // EdgeCostOverlay); edges costing INT_MAX are closed.
+    int dijkstra(int source, int destination, DynamicArray<int>& path,
+                 const int* edgeCosts = nullptr,
+                 SearchWorkspace& workspace = SearchWorkspace::forThisThread()) {
+        path.clear();
+        if (source < 0 || source >= numVertices || destination < 0 || destination >= numVertices) {
+            return 0;
+        }
+
+        const CSRGraph& csr = getSnapshot();
+        workspace.begin(numVertices);
+        workspace.setDistance(source, 0, -1);
+        workspace.queue.push(source, 0);
+
+        while (!workspace.queue.empty()) {
+            // Settle the closest vertex still in the queue
+            int u = workspace.queue.pop();
+            workspace.settle(u);
+
+            // Once the destination is settled its distance is final
+            if (u == destination) break;
+
+            // Relax the outgoing edges of u
+            int distU = workspace.distance(u);
+            for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); ++e) {
+                int cost = edgeCosts ? edgeCosts[e] : csr.weight(e);
+                if (cost == INT_MAX) continue;
+                int v = csr.target(e);
+                int newDist = distU + cost;
+
+                if (!workspace.isSettled(v) && newDist < workspace.distance(v)) {
+                    workspace.setDistance(v, newDist, u);
+                    workspace.queue.pushOrDecrease(v, newDist);
+                }
             }
         }
 
-        // If there are no more reachable vertices, break
-        if (u == -1) break;
+        return workspace.buildPath(destination, path);
+    }
+
+    // Bidirectional Dijkstra for a single source/destination pair. A forward
+    // search from the source and a backward search (over incoming edges) from
+    // the destination take turns settling their closest vertex; the best
+    // meeting distance is final once the two queue minimums add up to it.
+    // Same contract as dijkstra().
+    int bidirectionalDijkstra(int source, int destination, DynamicArray<int>& path,
+                              const int* edgeCosts = nullptr,
+                              SearchWorkspace& forward = SearchWorkspace::forThisThread(),
+                              SearchWorkspace& backward = SearchWorkspace::reverseForThisThread()) {
+        path.clear();
+        if (source < 0 || source >= numVertices || destination < 0 || destination >= numVertices) {
+            return 0;
+        }
 
-        visited[u] = true;  // Mark the vertex as visited
+        const CSRGraph& csr = getSnapshot();
+        forward.begin(numVertices);
+        backward.begin(numVertices);
+        forward.setDistance(source, 0, -1);
+        forward.queue.push(source, 0);
+        backward.setDistance(destination, 0, -1);
+        backward.queue.push(destination, 0);
 
-        // Update the distances of adjacent vertices
-        GNode* current = adjacencyList[u];
-        while (current != nullptr) {
-            int v = current->vertex;
-            int weight = current->weight;
+        int best = source == destination ? 0 : INT_MAX;
+        int meeting = source == destination ? source : -1;
 
-            // Relax the edge (if a shorter path is found)
-            if (dist[u] != INT_MAX && dist[u] + weight < dist[v]) {
-                dist[v] = dist[u] + weight;
-                prev[v] = u;
+        while (!forward.queue.empty() && !backward.queue.empty()) {
+            // Nothing left in either queue can improve on the best meeting
+            if (best != INT_MAX &&
+                (long long)forward.queue.topPriority() + backward.queue.topPriority() >= best) {
+                break;
             }
 
-            current = current->next;
+            if (forward.queue.topPriority() <= backward.queue.topPriority()) {
+                int u = forward.queue.pop();
+                forward.settle(u);
+                int distU = forward.distance(u);
+                for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); ++e) {
+                    int cost = edgeCosts ? edgeCosts[e] : csr.weight(e);
+                    if (cost == INT_MAX) continue;
+                    int v = csr.target(e);
+                    int newDist = distU + cost;
+                    if (!forward.isSettled(v) && newDist < forward.distance(v)) {
+                        forward.setDistance(v, newDist, u);
+                        forward.queue.pushOrDecrease(v, newDist);
+                    }
+                    if (backward.distance(v) != INT_MAX && newDist + backward.distance(v) < best) {
+                        best = newDist + backward.distance(v);
+                        meeting = v;
+                    }
+                }
+            } else {
+                int u = backward.queue.pop();
+                backward.settle(u);
+                int distU = backward.distance(u);
+                for (int i = csr.reverseBegin(u); i < csr.reverseEnd(u); ++i) {
+                    int e = csr.reverseEdge(i);
+                    int cost = edgeCosts ? edgeCosts[e] : csr.weight(e);
+                    if (cost == INT_MAX) continue;
+                    int v = csr.source(e);
+                    int newDist = distU + cost;
+                    if (!backward.isSettled(v) && newDist < backward.distance(v)) {
+                        backward.setDistance(v, newDist, u);
+                        backward.queue.pushOrDecrease(v, newDist);
+                    }
+                    if (forward.distance(v) != INT_MAX && newDist + forward.distance(v) < best) {
+                        best = newDist + forward.distance(v);
+                        meeting = v;
+                    }
+                }
+            }
         }
-    }
 
-    // Reconstruct the path from the destination to the source
-    int pathIndex = 0;
-    for (int node = destination; node != -1; node = prev[node]) {
-        path[pathIndex++] = node;  // Add node to the path
-    }
+        if (meeting == -1) return 0;
 
-    // Reverse the path array so it's from source to destination
-    for (int i = 0; i < pathIndex / 2; ++i) {
-        int temp = path[i];
-        path[i] = path[pathIndex - i - 1];
-        path[pathIndex - i - 1] = temp;
+        // source .. meeting from the forward tree, then meeting .. destination
+        // by following the backward tree's parents toward the destination
+        forward.buildPath(meeting, path);
+        for (int node = backward.parent(meeting); node != -1; node = backward.parent(node)) {
+            path.push_back(node);
+        }
+        return (int)path.size();
     }
 
-    // Clean up dynamically allocated memory
-    delete[] dist;
-    delete[] visited;
-    delete[] prev;
+    // A* search guided by the landmark lower bounds (ALT). Settles far fewer
+    // vertices than Dijkstra because it only expands toward the destination.
+    // Falls back to a plain Dijkstra order while the tables are invalid.
+    // Same contract as dijkstra().
+    // The landmark bounds stay admissible under edgeCosts as long as no cost
+    // is below the edge's weight, which holds for closures and penalties.
+    int astar(int source, int destination, DynamicArray<int>& path,
+              const int* edgeCosts = nullptr,
+              SearchWorkspace& workspace = SearchWorkspace::forThisThread()) {
+        path.clear();
+        if (source < 0 || source >= numVertices || destination < 0 || destination >= numVertices) {
+            return 0;
+        }
+
+        const CSRGraph& csr = getSnapshot();
+        bool useBounds = hasLandmarks();
+        workspace.begin(numVertices);
+        workspace.setDistance(source, 0, -1);
+        workspace.queue.push(source, useBounds ? landmarkBound(source, destination) : 0);
 
-    return pathIndex; // Return the number of nodes in the path
-}
+        while (!workspace.queue.empty()) {
+            int u = workspace.queue.pop();
+            workspace.settle(u);
+            if (u == destination) break;
 
+            int distU = workspace.distance(u);
+            for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); ++e) {
+                int cost = edgeCosts ? edgeCosts[e] : csr.weight(e);
+                if (cost == INT_MAX) continue;
+                int v = csr.target(e);
+                int newDist = distU + cost;
+                if (!workspace.isSettled(v) && newDist < workspace.distance(v)) {
+                    workspace.setDistance(v, newDist, u);
+                    int estimate = newDist + (useBounds ? landmarkBound(v, destination) : 0);
+                    workspace.queue.pushOrDecrease(v, estimate);
+                }
+            }
+        }
+
+        return workspace.buildPath(destination, path);
+    }
+
+    // Point-to-point route with the fastest engine available: ALT when the
+    // landmark tables are valid, bidirectional Dijkstra otherwise
+    int findRoute(int source, int destination, DynamicArray<int>& path,
+                  const int* edgeCosts = nullptr) {
+        if (hasLandmarks()) {
+            return astar(source, destination, path, edgeCosts);
+        }
+        return bidirectionalDijkstra(source, destination, path, edgeCosts);
+    }
 
 };
 
@@ -2,6 +2,8 @@
 #define HASH_TABLE_H
 
 #include <iostream>
+#include <new>
+#include <utility>
 
 
 template<typename K, typename V>
@@ -12,76 +14,185 @@ private:
         V value;
         Node* next;
         Node(const K& k, const V& v) : key(k), value(v), next(nullptr) {}
+        template<typename... Args>
+        Node(const K& k, Args&&... args) : key(k), value(std::forward<Args>(args)...), next(nullptr) {}
+    };
+
+    // Nodes are carved out of slabs owned by the table instead of being
+    // allocated one by one; removed nodes go on a free list for reuse and
+    // the memory is only returned when the table is destroyed
+    struct Slab {
+        Slab* next;
+        Node* nodes;
+    };
+
+    struct FreeNode {
+        FreeNode* next;
     };
 
     static const size_t DEFAULT_CAPACITY = 10;
+    static const size_t MIN_SLAB_NODES = 16;
+    static const size_t MAX_SLAB_NODES = 4096;
+
     Node** table;  // Array of Node pointers
     size_t capacity;
     size_t size;
 
+    Slab* slabs;         // newest first
+    size_t slabUsed;     // nodes handed out from slabs->nodes
+    size_t slabSize;     // nodes in slabs->nodes
+    FreeNode* freeNodes;
+
     size_t hash(const K& key) const {
         return std::hash<K>{}(key) % capacity;
     }
 
-    void rehash() {
+    void addSlab(size_t nodes) {
+        Slab* slab = new Slab;
+        slab->nodes = static_cast<Node*>(::operator new(sizeof(Node) * nodes));
+        slab->next = slabs;
+        slabs = slab;
+        slabUsed = 0;
+        slabSize = nodes;
+    }
+
+    template<typename... Args>
+    Node* allocateNode(const K& key, Args&&... args) {
+        void* memory;
+        if (freeNodes != nullptr) {
+            memory = freeNodes;
+            freeNodes = freeNodes->next;
+        } else {
+            if (slabs == nullptr || slabUsed == slabSize) {
+                // Each slab doubles the last, so n inserts cost O(log n) allocations
+                size_t nodes = slabSize * 2;
+                if (nodes < MIN_SLAB_NODES) nodes = MIN_SLAB_NODES;
+                if (nodes > MAX_SLAB_NODES) nodes = MAX_SLAB_NODES;
+                addSlab(nodes);
+            }
+            memory = &slabs->nodes[slabUsed++];
+        }
+        return new (memory) Node(key, std::forward<Args>(args)...);
+    }
+
+    void releaseNode(Node* node) {
+        node->~Node();
+        FreeNode* freed = reinterpret_cast<FreeNode*>(node);
+        freed->next = freeNodes;
+        freeNodes = freed;
+    }
+
+    // Moves every node into a bucket array of newCapacity by relinking
+    // them; no node is copied, freed or allocated
+    void rehash(size_t newCapacity) {
         size_t oldCapacity = capacity;
         Node** oldTable = table;
-        
-        // Create new array with double capacity
-        capacity *= 2;
+
+        capacity = newCapacity;
         table = new Node*[capacity]();
-        
-        // Reset size as items will be reinserted
-        size = 0;
-        
-        // Rehash all existing elements
+
         for (size_t i = 0; i < oldCapacity; i++) {
             Node* current = oldTable[i];
             while (current != nullptr) {
-                insert(current->key, current->value);
-                Node* temp = current;
-                current = current->next;
-                delete temp;
+                Node* next = current->next;
+                size_t index = hash(current->key);
+                current->next = table[index];
+                table[index] = current;
+                current = next;
             }
         }
-        
+
         delete[] oldTable;
     }
 
 public:
     explicit HashTable(size_t initialCapacity = DEFAULT_CAPACITY) 
-        : capacity(initialCapacity), size(0) {
+        : capacity(initialCapacity > 0 ? initialCapacity : 1), size(0),
+          slabs(nullptr), slabUsed(0), slabSize(0), freeNodes(nullptr) {
         table = new Node*[capacity]();  // Initialize all to nullptr
     }
 
     ~HashTable() {
         clear();
         delete[] table;
+        while (slabs != nullptr) {
+            Slab* next = slabs->next;
+            ::operator delete(slabs->nodes);
+            delete slabs;
+            slabs = next;
+        }
+    }
+
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+    // Makes room for n entries: buckets for n under the load factor and
+    // node storage for the entries not yet present, so loading n entries
+    // afterwards neither rehashes nor allocates
+    void reserve(size_t n) {
+        size_t neededCapacity = n * 4 / 3 + 1;
+        if (neededCapacity > capacity) {
+            rehash(neededCapacity);
+        }
+
+        size_t freeCount = 0;
+        for (FreeNode* node = freeNodes; node != nullptr && freeCount < n; node = node->next) freeCount++;
+        size_t needed = n > size + freeCount ? n - size - freeCount : 0;
+        if (needed > slabSize - slabUsed) {
+            // Nodes left in the current slab stay unused; the new slab covers the rest
+            addSlab(needed);
+        }
     }
 
     void insert(const K& key, const V& value) {
+        std::pair<V*, bool> result = try_emplace(key, value);
+        if (!result.second) *result.first = value;  // Update value
+    }
+
+    void insert(const K& key, V&& value) {
+        std::pair<V*, bool> result = try_emplace(key, std::move(value));
+        if (!result.second) *result.first = std::move(value);
+    }
+
+    // Constructs the value from args if key is absent. Returns the entry's
+    // value and whether it was inserted; an existing value is left as is.
+    template<typename... Args>
+    std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+        V* existing = find(key);
+        if (existing != nullptr) return std::make_pair(existing, false);
+
         // Check load factor and rehash if necessary
         if (size >= capacity * 0.75) {
-            rehash();
+            rehash(capacity * 2);
         }
 
+        // Create new node and add to front of chain
         size_t index = hash(key);
-        Node* current = table[index];
+        Node* newNode = allocateNode(key, std::forward<Args>(args)...);
+        newNode->next = table[index];
+        table[index] = newNode;
+        size++;
+        return std::make_pair(&newNode->value, true);
+    }
 
-        // Check if key already exists in the chain
+    // Value stored under key, or nullptr. Nodes never move, so the pointer
+    // stays valid until the entry is removed.
+    V* find(const K& key) {
+        Node* current = table[hash(key)];
         while (current != nullptr) {
-            if (current->key == key) {
-                current->value = value;  // Update value
-                return;
-            }
+            if (current->key == key) return &current->value;
             current = current->next;
         }
+        return nullptr;
+    }
 
-        // Create new node and add to front of chain
-        Node* newNode = new Node(key, value);
-        newNode->next = table[index];
-        table[index] = newNode;
-        size++;
+    const V* find(const K& key) const {
+        const Node* current = table[hash(key)];
+        while (current != nullptr) {
+            if (current->key == key) return &current->value;
+            current = current->next;
+        }
+        return nullptr;
     }
 
     bool remove(const K& key) {
@@ -96,7 +207,7 @@ public:
                 } else {
                     prev->next = current->next;
                 }
-                delete current;
+                releaseNode(current);
                 size--;
                 return true;
             }
@@ -107,34 +218,15 @@ public:
     }
 
     bool get(const K& key, V& value) const {
-        size_t index = hash(key);
-        Node* current = table[index];
-
-        while (current != nullptr) {
-            if (current->key == key) {
-                value = current->value;
-                return true;
-            }
-            current = current->next;
-        }
-        return false;
+        const V* found = find(key);
+        if (found == nullptr) return false;
+        value = *found;
+        return true;
     }
 
+    // Inserts a default value if key is absent
     V& operator[](const K& key) {
-        size_t index = hash(key);
-        Node* current = table[index];
-
-        while (current != nullptr) {
-            if (current->key == key) {
-                return current->value;
-            }
-            current = current->next;
-        }
-
-        // If key doesn't exist, insert default value
-        V defaultValue = V();
-        insert(key, defaultValue);
-        return operator[](key);  // Recursively get the newly inserted value
+        return *try_emplace(key).first;
     }
 
     void clear() {
@@ -143,13 +235,33 @@ public:
             while (current != nullptr) {
                 Node* temp = current;
                 current = current->next;
-                delete temp;
+                releaseNode(temp);
             }
             table[i] = nullptr;
         }
         size = 0;
     }
 
+    // Calls visit(key, value) once per entry, in bucket order. visit must
+    // not insert into or remove from the table.
+    template<typename F>
+    void forEach(F visit) {
+        for (size_t i = 0; i < capacity; i++) {
+            for (Node* current = table[i]; current != nullptr; current = current->next) {
+                visit(current->key, current->value);
+            }
+        }
+    }
+
+    template<typename F>
+    void forEach(F visit) const {
+        for (size_t i = 0; i < capacity; i++) {
+            for (const Node* current = table[i]; current != nullptr; current = current->next) {
+                visit(current->key, current->value);
+            }
+        }
+    }
+
     size_t getSize() const { return size; }
     size_t getCapacity() const { return capacity; }
     bool isEmpty() const { return size == 0; }
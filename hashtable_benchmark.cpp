@@ -0,0 +1,178 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include "hashtable.h"
+#include "flathashtable.h"
+#include "directtable.h"
+#include "roadkey.h"
+
+// Benchmark: chained HashTable against open-addressing FlatHashTable under
+// the simulator's per-tick access mix. For every vehicle a tick reads and
+// writes back its record, reads its signal, probes the closure table (mostly
+// misses) and moves one unit of congestion from one road key to the next.
+// A second run compares the three tables on lookups by intersection id
+// (signals, intersection load), where DirectTable applies.
+//
+//   g++ -O2 hashtable_benchmark.cpp -o hashtable_benchmark
+//   ./hashtable_benchmark
+
+using namespace std;
+
+// Stand-in for the simulator's Vehicle record (same size class)
+struct VehicleRecord {
+    string id;
+    int start;
+    int end;
+    int currentPosition;
+    int timeInCurrentSegment;
+    bool inTransit;
+    void* path[2];
+    void* timings[2];
+};
+
+template<template<typename, typename> class Table>
+long long runTicks(int numVehicles, int numIntersections, int ticks, double& ms) {
+    Table<string, VehicleRecord> vehicles;
+    Table<RoadKey, int> roadCongestion;
+    Table<RoadKey, int> closures;
+    Table<int, int> signals;
+
+    string* ids = new string[numVehicles];
+    RoadKey* roads = new RoadKey[numIntersections];
+    for (int i = 0; i < numIntersections; i++) {
+        roads[i] = RoadKey(i, (i + 1) % numIntersections);
+        if (i % 3 == 0) signals.insert(i, 30 + i % 20);
+        if (i % 50 == 0) closures.insert(roads[i], 1);
+    }
+    for (int v = 0; v < numVehicles; v++) {
+        ids[v] = "V" + to_string(v);
+        VehicleRecord record{ids[v], rand() % numIntersections, 0, 0, 0, true, {}, {}};
+        vehicles.insert(ids[v], record);
+    }
+
+    long long checksum = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        for (int v = 0; v < numVehicles; v++) {
+            VehicleRecord record;
+            if (!vehicles.get(ids[v], record)) continue;
+
+            int location = (record.start + record.currentPosition) % numIntersections;
+            int greenTime = 0;
+            if (signals.get(location, greenTime)) checksum += greenTime;
+
+            int closed = 0;
+            if (closures.get(roads[location], closed)) checksum += closed;
+
+            int count = 0;
+            roadCongestion.get(roads[location], count);
+            if (count > 0) roadCongestion.insert(roads[location], count - 1);
+            int next = (location + 1) % numIntersections;
+            count = 0;
+            roadCongestion.get(roads[next], count);
+            roadCongestion.insert(roads[next], count + 1);
+
+            record.currentPosition++;
+            record.timeInCurrentSegment = t;
+            vehicles.insert(ids[v], record);
+        }
+    }
+    ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count() / ticks;
+
+    for (int i = 0; i < numIntersections; i++) {
+        int count = 0;
+        if (roadCongestion.get(roads[i], count)) checksum += (long long)count * i;
+    }
+    for (int v = 0; v < numVehicles; v += 2) {
+        vehicles.remove(ids[v]);
+    }
+    checksum += vehicles.getSize();
+
+    delete[] ids;
+    delete[] roads;
+    return checksum;
+}
+
+// Per-tick signal and load lookups: every vehicle reads its intersection's
+// signal and bumps that intersection's load count
+template<typename Table>
+long long runIntersectionLookups(int numVehicles, int numIntersections, int ticks, double& ms) {
+    Table signals;
+    Table load;
+    for (int i = 0; i < numIntersections; i += 3) signals.insert(i, 30 + i % 20);
+    int* location = new int[numVehicles];
+    for (int v = 0; v < numVehicles; v++) location[v] = rand() % numIntersections;
+
+    long long checksum = 0;
+    auto begin = chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        for (int v = 0; v < numVehicles; v++) {
+            int greenTime = 0;
+            if (signals.get(location[v], greenTime)) checksum += greenTime;
+            load[location[v]]++;
+            location[v] = (location[v] + 1) % numIntersections;
+        }
+    }
+    ms = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count() / ticks;
+
+    for (int i = 0; i < numIntersections; i++) {
+        int count = 0;
+        if (load.get(i, count)) checksum += (long long)count * i;
+    }
+    delete[] location;
+    return checksum;
+}
+
+int main() {
+    const int fleetSizes[] = {100, 1000, 10000, 100000};
+    const int ticks[] = {2000, 200, 20, 5};
+
+    cout << "Hash table benchmark (average time per simulation tick)\n";
+    cout << "========================================================\n";
+
+    for (int s = 0; s < 4; s++) {
+        int numIntersections = fleetSizes[s] / 2 + 10;
+
+        srand(42);
+        double chainedMs = 0;
+        long long chainedChecksum = runTicks<HashTable>(fleetSizes[s], numIntersections, ticks[s], chainedMs);
+
+        srand(42);
+        double flatMs = 0;
+        long long flatChecksum = runTicks<FlatHashTable>(fleetSizes[s], numIntersections, ticks[s], flatMs);
+
+        cout << "Vehicles: " << fleetSizes[s] << "\n";
+        cout << "  HashTable (chained):        " << chainedMs << " ms\n";
+        cout << "  FlatHashTable (Robin Hood): " << flatMs << " ms\n";
+        cout << "  Speedup: " << chainedMs / flatMs << "x"
+             << (chainedChecksum == flatChecksum ? "" : "  (RESULTS DIFFER)") << "\n\n";
+    }
+
+    cout << "Lookups by intersection id (average time per simulation tick)\n";
+    cout << "==============================================================\n";
+
+    for (int s = 0; s < 4; s++) {
+        int numIntersections = fleetSizes[s] / 2 + 10;
+        double chainedMs = 0, flatMs = 0, directMs = 0;
+
+        srand(42);
+        long long chainedChecksum = runIntersectionLookups<HashTable<int, int>>(
+            fleetSizes[s], numIntersections, ticks[s] * 10, chainedMs);
+        srand(42);
+        long long flatChecksum = runIntersectionLookups<FlatHashTable<int, int>>(
+            fleetSizes[s], numIntersections, ticks[s] * 10, flatMs);
+        srand(42);
+        long long directChecksum = runIntersectionLookups<DirectTable<int, int>>(
+            fleetSizes[s], numIntersections, ticks[s] * 10, directMs);
+
+        cout << "Vehicles: " << fleetSizes[s] << "\n";
+        cout << "  HashTable (chained):        " << chainedMs << " ms\n";
+        cout << "  FlatHashTable (Robin Hood): " << flatMs << " ms\n";
+        cout << "  DirectTable (indexed):      " << directMs << " ms\n";
+        cout << "  Speedup vs. chained: " << chainedMs / directMs << "x"
+             << (chainedChecksum == flatChecksum && chainedChecksum == directChecksum ? "" : "  (RESULTS DIFFER)")
+             << "\n\n";
+    }
+    return 0;
+}
@@ -104,4 +104,212 @@ public:
     }
 };
 
+// Indexed min-priority queue over integer ids (0..n-1) with decrease-key.
+// Unlike PriorityQueue it has no fixed size: the heap and the id -> slot
+// index both grow on demand, so it can be used on graphs of any size.
+template<typename P>
+class IndexedPriorityQueue {
+private:
+    int* heap;          // heap of ids
+    P* priority;        // priority[id]
+    int* position;      // position[id] = slot in heap, -1 if not queued
+    size_t currentSize;
+    size_t heapCapacity;
+    size_t idCapacity;
+
+    void growHeap() {
+        size_t newCapacity = heapCapacity * 2;
+        int* newHeap = new int[newCapacity];
+        for (size_t i = 0; i < currentSize; i++) {
+            newHeap[i] = heap[i];
+        }
+        delete[] heap;
+        heap = newHeap;
+        heapCapacity = newCapacity;
+    }
+
+    void growIds(int id) {
+        size_t newCapacity = idCapacity;
+        while (newCapacity <= (size_t)id) {
+            newCapacity *= 2;
+        }
+        P* newPriority = new P[newCapacity];
+        int* newPosition = new int[newCapacity];
+        for (size_t i = 0; i < idCapacity; i++) {
+            newPriority[i] = priority[i];
+            newPosition[i] = position[i];
+        }
+        for (size_t i = idCapacity; i < newCapacity; i++) {
+            newPosition[i] = -1;
+        }
+        delete[] priority;
+        delete[] position;
+        priority = newPriority;
+        position = newPosition;
+        idCapacity = newCapacity;
+    }
+
+    void place(size_t index, int id) {
+        heap[index] = id;
+        position[id] = (int)index;
+    }
+
+    void heapifyUp(size_t index) {
+        int id = heap[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / 2;
+            if (!(priority[id] < priority[heap[parent]])) {
+                break;
+            }
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, id);
+    }
+
+    void heapifyDown(size_t index) {
+        int id = heap[index];
+        while (true) {
+            size_t leftChild = 2 * index + 1;
+            if (leftChild >= currentSize) {
+                break;
+            }
+            size_t selected = leftChild;
+            size_t rightChild = leftChild + 1;
+            if (rightChild < currentSize &&
+                priority[heap[rightChild]] < priority[heap[leftChild]]) {
+                selected = rightChild;
+            }
+            if (!(priority[heap[selected]] < priority[id])) {
+                break;
+            }
+            place(index, heap[selected]);
+            index = selected;
+        }
+        place(index, id);
+    }
+
+public:
+    explicit IndexedPriorityQueue(size_t initialCapacity = 16)
+        : currentSize(0),
+          heapCapacity(initialCapacity > 0 ? initialCapacity : 1),
+          idCapacity(initialCapacity > 0 ? initialCapacity : 1) {
+        heap = new int[heapCapacity];
+        priority = new P[idCapacity];
+        position = new int[idCapacity];
+        for (size_t i = 0; i < idCapacity; i++) {
+            position[i] = -1;
+        }
+    }
+
+    ~IndexedPriorityQueue() {
+        delete[] heap;
+        delete[] priority;
+        delete[] position;
+    }
+
+    IndexedPriorityQueue(const IndexedPriorityQueue&) = delete;
+    IndexedPriorityQueue& operator=(const IndexedPriorityQueue&) = delete;
+
+    bool contains(int id) const {
+        return id >= 0 && (size_t)id < idCapacity && position[id] != -1;
+    }
+
+    void push(int id, const P& value) {
+        if (contains(id)) {
+            throw "Id is already queued";
+        }
+        if ((size_t)id >= idCapacity) {
+            growIds(id);
+        }
+        if (currentSize == heapCapacity) {
+            growHeap();
+        }
+        priority[id] = value;
+        heap[currentSize] = id;
+        position[id] = (int)currentSize;
+        currentSize++;
+        heapifyUp(currentSize - 1);
+    }
+
+    // Lowers the priority of a queued id; ignored if value is not smaller
+    void decreaseKey(int id, const P& value) {
+        if (!contains(id)) {
+            throw "Id is not queued";
+        }
+        if (value < priority[id]) {
+            priority[id] = value;
+            heapifyUp(position[id]);
+        }
+    }
+
+    // Sets a queued id's priority to value, moving it up or down as needed
+    void changeKey(int id, const P& value) {
+        if (!contains(id)) {
+            throw "Id is not queued";
+        }
+        P old = priority[id];
+        priority[id] = value;
+        if (value < old) {
+            heapifyUp(position[id]);
+        } else {
+            heapifyDown(position[id]);
+        }
+    }
+
+    // Inserts the id, or lowers its priority if it is already queued
+    void pushOrDecrease(int id, const P& value) {
+        if (contains(id)) {
+            decreaseKey(id, value);
+        } else {
+            push(id, value);
+        }
+    }
+
+    int pop() {
+        if (currentSize == 0) {
+            throw "Heap is empty";
+        }
+        int top = heap[0];
+        position[top] = -1;
+        currentSize--;
+        if (currentSize > 0) {
+            heap[0] = heap[currentSize];
+            position[heap[0]] = 0;
+            heapifyDown(0);
+        }
+        return top;
+    }
+
+    int top() const {
+        if (currentSize == 0) {
+            throw "Heap is empty";
+        }
+        return heap[0];
+    }
+
+    const P& topPriority() const {
+        if (currentSize == 0) {
+            throw "Heap is empty";
+        }
+        return priority[heap[0]];
+    }
+
+    bool empty() const {
+        return currentSize == 0;
+    }
+
+    size_t size() const {
+        return currentSize;
+    }
+
+    // O(size): only the ids still in the heap need their slot reset
+    void clear() {
+        for (size_t i = 0; i < currentSize; i++) {
+            position[heap[i]] = -1;
+        }
+        currentSize = 0;
+    }
+};
+
 #endif // PRIORITY_QUEUE_H
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef HIERARCHY_BUILDER_H
+#define HIERARCHY_BUILDER_H
+
+#include <atomic>
+#include <thread>
+#include "graph.h"
+#include "contractionhierarchy.h"
+
+// Keeps a contraction hierarchy for a graph without contracting on the
+// caller's thread. Contraction takes seconds on large networks, so it runs on
+// a worker thread over a private copy of the roads, and the finished
+// hierarchy is picked up by the next call to current(). When the graph's
+// weights change, current() starts a rebuild and returns nullptr (search the
+// graph instead) until the new hierarchy is ready.
+//
+// Every method is for the thread that owns the graph.
+class HierarchyBuilder {
+private:
+    DirectedWeightedGraph& graph;
+    ContractionHierarchy* hierarchy;        // latest one finished; may be outdated
+    ContractionHierarchy* built;            // the worker's result
+    CSRGraph* roads;                        // the worker's copy of the graph
+    unsigned long roadsVersion;
+    std::thread worker;
+    std::atomic<bool> finished;
+    bool building;
+
+    // Takes over the worker's hierarchy once it has finished
+    void collect() {
+        worker.join();
+        building = false;
+        delete roads;
+        roads = nullptr;
+        delete hierarchy;
+        hierarchy = built;
+        built = nullptr;
+    }
+
+public:
+    explicit HierarchyBuilder(DirectedWeightedGraph& g)
+        : graph(g), hierarchy(nullptr), built(nullptr), roads(nullptr), roadsVersion(0),
+          finished(false), building(false) {}
+
+    ~HierarchyBuilder() {
+        if (building) collect();
+        delete hierarchy;
+    }
+
+    HierarchyBuilder(const HierarchyBuilder&) = delete;
+    HierarchyBuilder& operator=(const HierarchyBuilder&) = delete;
+
+    // Starts contracting the graph as it is now, unless a build is already
+    // running or the hierarchy is up to date
+    void start() {
+        if (building) return;
+        if (hierarchy != nullptr && hierarchy->isCurrent(graph)) return;
+        roads = graph.copySnapshot();
+        roadsVersion = graph.getVersion();
+        finished.store(false, std::memory_order_relaxed);
+        building = true;
+        worker = std::thread([this]() {
+            built = new ContractionHierarchy(*roads, roadsVersion);
+            finished.store(true, std::memory_order_release);
+        });
+    }
+
+    // Blocks until the running build, if any, has finished
+    void wait() {
+        if (building) collect();
+    }
+
+    // The hierarchy if it matches the graph's current weights, else nullptr;
+    // an outdated one is rebuilt in the background
+    ContractionHierarchy* current() {
+        if (building && finished.load(std::memory_order_acquire)) collect();
+        if (hierarchy != nullptr && hierarchy->isCurrent(graph)) return hierarchy;
+        start();
+        return nullptr;
+    }
+};
+
+#endif // HIERARCHY_BUILDER_H
@@ -4,10 +4,25 @@
 #include <ctime>
 #include <chrono>
 #include <thread>
-#include <conio.h>
+#include "console.h"
 #include "graph.h"
+#include "contractionhierarchy.h"
+#include "hierarchybuilder.h"
+#include "routeplanner.h"
+#include "routecache.h"
+#include "costoverlay.h"
+#include "symboltable.h"
+#include "roadkey.h"
 #include "queue.h"
 #include "hashtable.h"
+#include "directtable.h"
+#include "route.h"
+#include "vehiclestore.h"
+#include "simclock.h"
+#include "eventqueue.h"
+#include "threadpool.h"
+#include "triplebuffer.h"
+#include "commandqueue.h"
 #include "heap.h"
 #include "doublylinkedlist.h"
 #include <cstdlib>
@@ -24,17 +39,41 @@ const string GREEN = "\033[32m";
 const string YELLOW = "\033[33m";
 
 struct TrafficSignal {
-    char intersection;
+    int intersection;
     bool isGreen;
     int greenDuration;
-    time_t lastChange;
+    long lastChange;              // simulated second of the last change
+    unsigned generation;          // bumped on every change; older SIGNAL_CHANGE events are stale
+    int holds;                    // emergency vehicles holding it; it doesn't cycle while held
+};
+
+// Something the simulation does at a known second (see EventQueue)
+struct SimEvent {
+    enum Type { VEHICLE_EXIT, EMERGENCY_EXIT, SIGNAL_CHANGE, REPAIR_DONE };
+    Type type;
+    int target;                   // vehicle slot or index, intersection, or road start
+    int other;                    // road end for REPAIR_DONE
+    unsigned generation;          // target's generation when scheduled; stale events are dropped
+};
+
+typedef EventQueue<SimEvent> SimEventQueue;
+
+// Operator action queued by the UI (or any other thread) for the simulation
+// thread. Fixed size, so queueing one never allocates.
+struct SimCommand {
+    enum Type { SIGNAL_OVERRIDE, ROAD_CLOSURE, ADD_VEHICLE };
+    static const size_t TEXT_SIZE = 32;
+    Type type;
+    int from;                     // overridden intersection, closed road's start or vehicle's start
+    int to;                       // closed road's end or vehicle's destination
+    char text[TEXT_SIZE];         // closure status or vehicle id, null-terminated
 };
 struct EmergencyVehicle {
     string id;
-    char start;
-    char end;
+    int start;
+    int end;
     string priority;
-    LinkedList<char> path;
+    LinkedList<int> path;
     int currentPosition;
     bool inTransit;
 };
@@ -42,31 +81,51 @@ struct EmergencyVehicle {
 
 class RoadClosureManager {
 private:
+    static const int REPAIR_SECONDS = 10;        // "Under Repair" roads reopen after this long
+
     struct RoadStatus {
         string status;
-        time_t blockStartTime;                    // how long to block accidented roads
+        long blockStartTime;                      // simulated second the road was closed
         RoadStatus() : status("Clear"), blockStartTime(0) {}
-        RoadStatus(string s, time_t t) : status(s), blockStartTime(t) {}
-        bool isBlocked() { 
+        RoadStatus(string s, long t) : status(s), blockStartTime(t) {}
+        bool isBlocked(long now) const {
             if(status == "Clear") return false;
             if(status == "Blocked") return true;
             if(status == "Under Repair") {
-                return difftime(time(nullptr), blockStartTime) < 10;
+                return now - blockStartTime < REPAIR_SECONDS;
             }
             return false;
         }
     };
-    
-    HashTable<string, RoadStatus> closures;
-    DirectedWeightedGraph* graph;
-    
-    string makeRoadKey(char start, char end) {
-        return string(1, start) + "-" + string(1, end);
+
+    HashTable<RoadKey, RoadStatus> closures;
+    const SymbolTable* intersections;
+    EdgeCostOverlay* overlay;                    // closed roads cost INT_MAX for route searches
+    SimEventQueue* events;                       // repairs end with a REPAIR_DONE event
+
+    // Copies the road's current status into the cost overlay
+    void applyToOverlay(int start, int end) {
+        if(overlay == nullptr) return;
+        overlay->setBlocked(start, end, isRoadBlocked(start, end));
+    }
+
+    void recordClosure(int start, int end, const string& status) {
+        RoadStatus rs{status, events->now()};
+        closures.insert(makeRoadKey(start, end), rs);
+        if(status == "Under Repair") {
+            events->schedule(rs.blockStartTime + REPAIR_SECONDS, SimEvent{SimEvent::REPAIR_DONE, start, end, 0});
+        }
+        applyToOverlay(start, end);
+    }
+
+    RoadKey makeRoadKey(int start, int end) {
+        return RoadKey(start, end);
     }
 
 public:
-    RoadClosureManager(DirectedWeightedGraph* g) : graph(g) {}
-    
+    RoadClosureManager(const SymbolTable* names, SimEventQueue* e, EdgeCostOverlay* o = nullptr)
+        : intersections(names), overlay(o), events(e) {}
+        
     void loadClosures(const string& filename) {                           //Load road closures file
         ifstream file(filename);
         string line;
@@ -74,53 +133,53 @@ public:
             stringstream ss(line);
             string from, to, status;
             if(getline(ss, from, ',') && getline(ss, to, ',') && getline(ss, status, ',')) {
-                if(from.empty() || to.empty()) continue;
-                RoadStatus rs{status, time(nullptr)};
-                closures.insert(makeRoadKey(from[0], to[0]), rs);
+                int start = intersections->find(from);
+                int end = intersections->find(to);
+                if(start == -1 || end == -1) continue;      // header row or unknown intersection
+                recordClosure(start, end, status);
             }
         }
     }
-      void addClosure(const string& roadKey, const string& status) {
-        RoadStatus rs{status, time(nullptr)};
-        closures.insert(roadKey, rs);
+      void addClosure(int start, int end, const string& status) {
+        recordClosure(start, end, status);
+    }
+
+    // Reopens the road in the cost overlay once its repair time is up
+    void onRepairDone(const SimEvent& event) {
+        applyToOverlay(event.target, event.other);
     }
     
 
-    bool isRoadBlocked(char start, char end) { //Check if road is blocked
+    bool isRoadBlocked(int start, int end) { //Check if road is blocked
         RoadStatus status;
         if(closures.get(makeRoadKey(start, end), status)) {
-            return status.isBlocked();
+            return status.isBlocked(events->now());
         }
         return false;
     }
 
-     void displayClosures() {
-       cout << "\nRoad Closures Status:\n";
-       cout << "===================\n";
+     void displayClosures(ostream& out = cout) {
+       out << "\nRoad Closures Status:\n";
+       out << "===================\n";
        
-       for(char start = 'A'; start <= 'Z'; start++) {
-           for(char end = 'A'; end <= 'Z'; end++) {
-               RoadStatus status;
-               string key = makeRoadKey(start, end);
-               if(closures.get(key, status)) {
-                   cout << start << " -> " << end << ": ";
-                   if(status.status == "Under Repair") {
-                       if(status.isBlocked()) {
-                           cout << RED << "Under Repair (" << 
-                               10 - (int)difftime(time(nullptr), status.blockStartTime) <<                    //simple display function for road closures
-                               "s remaining)" << RESET;
-                       } else {
-                           cout << GREEN << "REPAIRED" << RESET;
-                       }
-                   } else if(status.status == "Blocked") {
-                       cout << RED << "BLOCKED" << RESET;
-                   } else {
-                       cout << GREEN << "CLEAR" << RESET;
-                   }
-                   cout << endl;
+       long now = events->now();
+       closures.forEach([&](const RoadKey& key, const RoadStatus& status) {
+           out << intersections->name(key.from()) << " -> " << intersections->name(key.to()) << ": ";
+           if(status.status == "Under Repair") {
+               if(status.isBlocked(now)) {
+                   out << RED << "Under Repair (" << 
+                       REPAIR_SECONDS - (now - status.blockStartTime) <<                    //simple display function for road closures
+                       "s remaining)" << RESET;
+               } else {
+                   out << GREEN << "REPAIRED" << RESET;
                }
+           } else if(status.status == "Blocked") {
+               out << RED << "BLOCKED" << RESET;
+           } else {
+               out << GREEN << "CLEAR" << RESET;
            }
-       }
+           out << endl;
+       });
    }
 };
 
@@ -128,127 +187,105 @@ public:
 
 class CongestionMonitor {
 private:
-    HashTable<string, int> roadCongestion; // key: "start-end", value: vehicle count
+    HashTable<RoadKey, int> roadCongestion; // key: (start, end), value: vehicle count
     const int CONGESTION_THRESHOLD = 3;
+    const int CONGESTION_COST_FACTOR = 2;  // congested roads count as this many times slower
+    EdgeCostOverlay* overlay;
+    DirectedWeightedGraph* graph;
+    const SymbolTable* intersections;
+
+    // Adds or removes the congestion penalty when a road crosses the threshold
+    void applyToOverlay(int start, int end, int oldCount, int newCount) {
+        if(overlay == nullptr) return;
+        bool wasCongested = oldCount >= CONGESTION_THRESHOLD;
+        bool isCongested = newCount >= CONGESTION_THRESHOLD;
+        if(wasCongested == isCongested) return;
+
+        const CSRGraph& csr = graph->getSnapshot();
+        if(start < 0 || start >= csr.getNumVertices()) return;
+        for(int e = csr.edgeBegin(start); e < csr.edgeEnd(start); e++) {
+            if(csr.target(e) == end) {
+                overlay->setPenalty(e, isCongested ? csr.weight(e) * (CONGESTION_COST_FACTOR - 1) : 0);
+            }
+        }
+    }
     
-    string makeRoadKey(char start, char end) {
-        string key;
-        key += start;
-        key += "-";
-        key += end;
-        return key;                                           
+    RoadKey makeRoadKey(int start, int end) {
+        return RoadKey(start, end);
     }
 
 public:
-    void updateCongestion(const LinkedList<char>& path, int currentPosition) {
-        Node<char>* current = path.head;
-        for(int i = 0; i < currentPosition && current && current->next; i++) {           //update congesion levels when a vehicle moves
-            current = current->next;
-        }
-        
-        if(current && current->next) {
-            string roadKey = makeRoadKey(current->data, current->next->data);
-            int count = 0;
-            roadCongestion.get(roadKey, count);
-            roadCongestion.insert(roadKey, count + 1);
-        }
+    CongestionMonitor() : overlay(nullptr), graph(nullptr), intersections(nullptr) {}
+
+    void setNetwork(DirectedWeightedGraph* g, const SymbolTable* names) {
+        graph = g;
+        intersections = names;
     }
 
-    void decreaseCongestion(const LinkedList<char>& path, int position) {           //decrease congesion levels when a vehicle moves                   
-        Node<char>* current = path.head;
-        for(int i = 0; i < position && current && current->next; i++) {
-            current = current->next;
-        }
-        
-        if(current && current->next) {
-            string roadKey = makeRoadKey(current->data, current->next->data);
-            int count = 0;
-            roadCongestion.get(roadKey, count);
-            if(count > 0) {
-                roadCongestion.insert(roadKey, count - 1);
-            }
+    void setCostOverlay(EdgeCostOverlay* o) { overlay = o; }
+
+    // A vehicle entered road e (a CSR edge id; -1 for none)
+    void updateCongestion(int e) {
+        if(e == -1) return;                                                   //update congesion levels when a vehicle moves
+        const CSRGraph& csr = graph->getSnapshot();
+        int start = csr.source(e);
+        int end = csr.target(e);
+        int& count = roadCongestion[makeRoadKey(start, end)];
+        count++;
+        applyToOverlay(start, end, count - 1, count);
+    }
+
+    // A vehicle left road e
+    void decreaseCongestion(int e) {                                         //decrease congesion levels when a vehicle moves
+        if(e == -1) return;
+        const CSRGraph& csr = graph->getSnapshot();
+        int start = csr.source(e);
+        int end = csr.target(e);
+        int* count = roadCongestion.find(makeRoadKey(start, end));
+        if(count != nullptr && *count > 0) {
+            (*count)--;
+            applyToOverlay(start, end, *count + 1, *count);
         }
     }
 
-    bool isRoadCongested(char start, char end) {                             
-        string roadKey = makeRoadKey(start, end);
+    // Net change on road e from a batch of road exits: left vehicles left
+    // it, then entered vehicles entered it
+    void adjustCongestion(int e, int left, int entered) {
+        if(e == -1 || (left == 0 && entered == 0)) return;
+        const CSRGraph& csr = graph->getSnapshot();
+        int start = csr.source(e);
+        int end = csr.target(e);
+        RoadKey roadKey = makeRoadKey(start, end);
+        if(entered == 0 && roadCongestion.find(roadKey) == nullptr) return;
+        int& count = roadCongestion[roadKey];
+        int oldCount = count;
+        count = max(0, count - left) + entered;
+        applyToOverlay(start, end, oldCount, count);
+    }
+
+    bool isRoadCongested(int start, int end) {                             
+        RoadKey roadKey = makeRoadKey(start, end);
         int count = 0;
         roadCongestion.get(roadKey, count);
         return count >= CONGESTION_THRESHOLD;
     }
 
-    void displayCongestionLevels() {
-        cout << "\nRoad Congestion Levels:\n";
-        cout << "=====================\n";
-        
-        for(char start = 'A'; start <= 'Z'; start++) {
-            for(char end = 'A'; end <= 'Z'; end++) {
-                string roadKey = makeRoadKey(start, end);
-                int count = 0;
-                if(roadCongestion.get(roadKey, count) && count > 0) {
-                    cout << start << " -> " << end << ": ";
-                    if(count >= CONGESTION_THRESHOLD) {
-                        cout << RED << count << " vehicles (CONGESTED)" << RESET;
-                    } else {
-                        cout << GREEN << count << " vehicles" << RESET;
-                    }
-                    cout << endl;
-                }
-            }
-        }
-    }
-
-    // BFS to find alternative routes avoiding congested roads
-    LinkedList<char> findAlternativeRoute(DirectedWeightedGraph* graph, char start, char end) {
-        const int MAX_VERTICES = 26;
-        bool visited[MAX_VERTICES] = {false};
-        char parent[MAX_VERTICES];
-        CustomQueue<char> queue;
+    void displayCongestionLevels(ostream& out = cout) {
+        out << "\nRoad Congestion Levels:\n";
+        out << "=====================\n";
         
-        queue.enqueue(start);
-        visited[start - 'A'] = true;
-        
-        while(!queue.isEmpty()) {
-            char current = queue.dequeue();
-            
-            if(current == end) {
-                LinkedList<char> path;
-                char temp = end;
-                while(temp != start) {
-                    path.insertAtHead(temp);
-                    temp = parent[temp - 'A'];
-                }
-                path.insertAtHead(start);
-                return path;
-            }
-            
-            GNode* edges = graph->getEdges(current - 'A');
-            while(edges) {
-                char nextVertex = edges->vertex + 'A';
-                if(!visited[nextVertex - 'A'] && !isRoadCongested(current, nextVertex)) {
-                    visited[nextVertex - 'A'] = true;
-                    parent[nextVertex - 'A'] = current;
-                    queue.enqueue(nextVertex);
-                }
-                edges = edges->next;
+        roadCongestion.forEach([&](const RoadKey& roadKey, int count) {
+            if(count <= 0) return;
+            out << intersections->name(roadKey.from()) << " -> " << intersections->name(roadKey.to()) << ": ";
+            if(count >= CONGESTION_THRESHOLD) {
+                out << RED << count << " vehicles (CONGESTED)" << RESET;
+            } else {
+                out << GREEN << count << " vehicles" << RESET;
             }
-        }
-        
-        LinkedList<char> emptyPath;
-        return emptyPath;
+            out << endl;
+        });
     }
 };
-struct Vehicle {
-    string id;
-    char start;
-    char end;
-    LinkedList<char> path;
-    LinkedList<int> timings;
-    int currentPosition;
-    int timeInCurrentSegment;
-    bool inTransit;               //checking if vehicle is moving
-};
-
 class TrafficAnalytics {
 private:
     struct TravelMetrics {
@@ -257,38 +294,32 @@ private:
         double maxTime;
         int totalVehicles;
         int delayedVehicles;
+        double hourlyAverage[24];    // running average per hour of day, 0 if none
         
         TravelMetrics() : averageTime(0), minTime(DBL_MAX), maxTime(0), 
-                         totalVehicles(0), delayedVehicles(0) {}
+                         totalVehicles(0), delayedVehicles(0) {
+            for(int hour = 0; hour < 24; hour++) hourlyAverage[hour] = 0;
+        }
     };
 
-    HashTable<string, TravelMetrics> routeMetrics;
-    HashTable<char, int> intersectionLoadCount;
-    HashTable<string, double> peakHourMetrics;
+    HashTable<RoadKey, TravelMetrics> routeMetrics;
+    DirectTable<int, int> intersectionLoadCount;
+    const SymbolTable* intersections;
     int totalEmergencyResponses;
     int totalAccidents;
-    time_t startTime;
-    
-    string makeRouteKey(char start, char end) {
-        return string(1, start) + "-" + string(1, end);
+    const SimClock* clock;                                        // simulated time, for runtime and hour of day
+
+    RoadKey makeRouteKey(int start, int end) {
+        return RoadKey(start, end);
     }
 
 public:
-    TrafficAnalytics() : totalEmergencyResponses(0), totalAccidents(0) {
-        startTime = time(nullptr);
-    }
+    TrafficAnalytics(const SymbolTable* names, const SimClock* c)
+        : intersections(names), totalEmergencyResponses(0), totalAccidents(0), clock(c) {}
 
-    void recordVehicleCompletion(const Vehicle& vehicle, bool delayed) {
-        string routeKey = makeRouteKey(vehicle.start, vehicle.end);
-        TravelMetrics metrics;
-        routeMetrics.get(routeKey, metrics);
-        
-        double totalTime = 0;
-        Node<int>* timing = vehicle.timings.head;
-        while(timing) {
-            totalTime += timing->data;
-            timing = timing->next;
-        }
+    void recordVehicleCompletion(int start, int end, double totalTime, bool delayed) {
+        RoadKey routeKey = makeRouteKey(start, end);
+        TravelMetrics& metrics = routeMetrics[routeKey];
 
         metrics.minTime = min(metrics.minTime, totalTime);
         metrics.maxTime = max(metrics.maxTime, totalTime);
@@ -297,21 +328,13 @@ public:
         metrics.totalVehicles++;
         if(delayed) metrics.delayedVehicles++;
         
-        routeMetrics.insert(routeKey, metrics);
-        
         // Record peak hour metrics
-        time_t currentTime = time(nullptr);
-        int currentHour = (currentTime / 3600) % 24;
-        string hourKey = routeKey + "-" + to_string(currentHour);
-        double currentHourAvg = 0;
-        peakHourMetrics.get(hourKey, currentHourAvg);
-        peakHourMetrics.insert(hourKey, (currentHourAvg + totalTime) / 2);
+        int currentHour = clock->hourOfDay();
+        metrics.hourlyAverage[currentHour] = (metrics.hourlyAverage[currentHour] + totalTime) / 2;
     }
 
-    void recordIntersectionLoad(char intersection) {
-        int count = 0;
-        intersectionLoadCount.get(intersection, count);
-        intersectionLoadCount.insert(intersection, count + 1);
+    void recordIntersectionLoad(int intersection) {
+        intersectionLoadCount[intersection]++;
     }
 
     void recordEmergencyResponse() {
@@ -322,58 +345,50 @@ public:
         totalAccidents++;
     }
 
-    void displayMetrics() {
-        time_t currentTime = time(nullptr);
-        double hoursElapsed = difftime(currentTime, startTime) / 3600.0;
+    void displayMetrics(ostream& out = cout) {
+        double hoursElapsed = clock->hoursElapsed();
         
-        cout << "\nTraffic System Performance Metrics\n";
-        cout << "================================\n";
-        cout << "System Runtime: " << fixed << setprecision(2) << hoursElapsed << " hours\n";
-        cout << "Total Accidents: " << totalAccidents << "\n";
-        cout << "Emergency Responses: " << totalEmergencyResponses << "\n";
+        out << "\nTraffic System Performance Metrics\n";
+        out << "================================\n";
+        out << "System Runtime: " << fixed << setprecision(2) << hoursElapsed << " hours\n";
+        out << "Total Accidents: " << totalAccidents << "\n";
+        out << "Emergency Responses: " << totalEmergencyResponses << "\n";
         
-        cout << "\nRoute Performance:\n";
-        for(char start = 'A'; start <= 'Z'; start++) {
-            for(char end = 'A'; end <= 'Z'; end++) {
-                string routeKey = makeRouteKey(start, end);
-                TravelMetrics metrics;
-                if(routeMetrics.get(routeKey, metrics) && metrics.totalVehicles > 0) {
-                    double delayRate = (double)metrics.delayedVehicles / metrics.totalVehicles * 100;
-                    
-                    // Find peak hour for this route
-                    double peakTime = 0;
-                    int peakHour = -1;
-                    for(int hour = 0; hour < 24; hour++) {
-                        string hourKey = routeKey + "-" + to_string(hour);
-                        double hourAvg = 0;
-                        if(peakHourMetrics.get(hourKey, hourAvg) && hourAvg > peakTime) {
-                            peakTime = hourAvg;
-                            peakHour = hour;
-                        }
-                    }
-                    
-                    cout << start << " -> " << end << ":\n"
-                         << "  Vehicles: " << metrics.totalVehicles << "\n"
-                         << "  Min Time: " << metrics.minTime << "s\n"
-                         << "  Max Time: " << metrics.maxTime << "s\n"
-                         << "  Avg Time: " << metrics.averageTime << "s\n"
-                         << "  Delay Rate: " << delayRate << "%\n";
-                    if(peakHour != -1) {
-                        cout << "  Peak Hour: " << peakHour << ":00 (Avg: " << peakTime << "s)\n";
+        out << "\nRoute Performance:\n";
+        routeMetrics.forEach([&](const RoadKey& route, const TravelMetrics& metrics) {
+            if(metrics.totalVehicles > 0) {
+                double delayRate = (double)metrics.delayedVehicles / metrics.totalVehicles * 100;
+                
+                // Find peak hour for this route
+                double peakTime = 0;
+                int peakHour = -1;
+                for(int hour = 0; hour < 24; hour++) {
+                    if(metrics.hourlyAverage[hour] > peakTime) {
+                        peakTime = metrics.hourlyAverage[hour];
+                        peakHour = hour;
                     }
-                    cout << "\n";
                 }
+                
+                out << intersections->name(route.from()) << " -> " << intersections->name(route.to()) << ":\n"
+                     << "  Vehicles: " << metrics.totalVehicles << "\n"
+                     << "  Min Time: " << metrics.minTime << "s\n"
+                     << "  Max Time: " << metrics.maxTime << "s\n"
+                     << "  Avg Time: " << metrics.averageTime << "s\n"
+                     << "  Delay Rate: " << delayRate << "%\n";
+                if(peakHour != -1) {
+                    out << "  Peak Hour: " << peakHour << ":00 (Avg: " << peakTime << "s)\n";
+                }
+                out << "\n";
             }
-        }
+        });
         
-        cout << "\nIntersection Load:\n";
-        for(char intersection = 'A'; intersection <= 'Z'; intersection++) {
-            int count = 0;
-            if(intersectionLoadCount.get(intersection, count) && count > 0) {
-                cout << "Intersection " << intersection << ": "
+        out << "\nIntersection Load:\n";
+        intersectionLoadCount.forEach([&](int intersection, int count) {
+            if(count > 0) {
+                out << "Intersection " << intersections->name(intersection) << ": "
                      << count << " vehicles/hour\n";
             }
-        }
+        });
     }
 };
 
@@ -383,585 +398,813 @@ public:
 
 class SignalManagementSystem {
 private:
-    HashTable<char, TrafficSignal*> signals;
+    DirectTable<int, TrafficSignal*> signals;
+    const SymbolTable* intersections;
+    SimEventQueue* events;                       // each signal has its next change scheduled
+    DynamicArray<int> turnedGreen;               // intersections whose signal turned green, not yet taken
+
+    // Schedules the signal's next change greenDuration after its last one,
+    // unless it is held; any change scheduled before is now stale
+    void scheduleChange(TrafficSignal* signal) {
+        signal->generation++;
+        if(signal->holds == 0) {
+            events->schedule(signal->lastChange + signal->greenDuration,
+                             SimEvent{SimEvent::SIGNAL_CHANGE, signal->intersection, 0, signal->generation});
+        }
+    }
+
+    void setGreen(TrafficSignal* signal, bool green) {
+        if(green && !signal->isGreen) turnedGreen.push_back(signal->intersection);
+        signal->isGreen = green;
+        signal->lastChange = events->now();
+        scheduleChange(signal);
+    }
 
 public:
-  bool getSignalStatus(char intersection, TrafficSignal*& signal) {             //to return whether signal is red or green
+    SignalManagementSystem(const SymbolTable* names, SimEventQueue* e)
+        : signals(names->size()), intersections(names), events(e) {}
+
+  bool getSignalStatus(int intersection, TrafficSignal*& signal) {             //to return whether signal is red or green
     return signals.get(intersection, signal);
 }
-    void addSignal(char intersection, int duration) {                          //dynamically allocating sugnals 
+    void addSignal(int intersection, int duration) {                          //dynamically allocating sugnals
         TrafficSignal* signal = new TrafficSignal{
             intersection,
             false,
             duration,
-            time(nullptr)
+            events->now(),
+            0,
+            0
         };
-        signals.insert(intersection, signal);
+        TrafficSignal* existing;
+        if(signals.get(intersection, existing)) {
+            signal->generation = existing->generation;       // keeps its pending change stale
+            *existing = *signal;
+            delete signal;
+            signal = existing;
+        } else {
+            signals.insert(intersection, signal);
+        }
+        scheduleChange(signal);
     }
 
 
 
-void processSignals() {
-    time_t currentTime = time(nullptr);
-    for(char i = 'A'; i <= 'Z'; i++) {
-        TrafficSignal* signal;
-        if(signals.get(i, signal)) {
-            if(difftime(currentTime, signal->lastChange) >= signal->greenDuration) {
-                signal->isGreen = !signal->isGreen;
-                signal->lastChange = currentTime;
-            }
-        }
-    }
+// Cycles the signal if event is still its pending change
+void onSignalChange(const SimEvent& event) {
+    TrafficSignal* signal;
+    if(!signals.get(event.target, signal) || event.generation != signal->generation) return;
+    setGreen(signal, !signal->isGreen);
 }
 
-void emergencyOverride(char intersection) {                       //  for turning signal to green no matter what the state is for emergency situations
+void emergencyOverride(int intersection) {                       //  for turning signal to green no matter what the state is for emergency situations
     TrafficSignal* signal;
     if(signals.get(intersection, signal)) {
-        signal->isGreen = true;
-        signal->lastChange = time(nullptr);
+        setGreen(signal, true);
     }
 }
 
-void displaySignalStatus() {
-   cout << "\nTraffic Signal Status:\n";
-   cout << "=====================\n";
-   time_t currentTime = time(nullptr);                         //display function (please improve formating later) for signals
-   TrafficSignal* signal;
-   
-   for(char i = 'A'; i <= 'Z'; i++) {
-       if(signals.get(i, signal)) {
-           int timeLeft = signal->greenDuration - difftime(currentTime, signal->lastChange);
-           cout << "Intersection " << i << ": "
-                << (signal->isGreen ? GREEN + "GREEN" : RED + "RED") << RESET 
-                << " (" << timeLeft << " seconds until change)" << endl;
+    // Keeps the signal green (or red) while an emergency vehicle needs it;
+    // it resumes cycling greenDuration after the last hold is released
+    void hold(int intersection, bool green) {
+        TrafficSignal* signal;
+        if(signals.get(intersection, signal)) {
+            signal->holds++;
+            setGreen(signal, green);
+        }
+    }
+
+    void release(int intersection) {
+        TrafficSignal* signal;
+        if(signals.get(intersection, signal) && signal->holds > 0) {
+            signal->holds--;
+            if(signal->holds == 0) {
+                signal->lastChange = events->now();
+                scheduleChange(signal);
+            }
+        }
+    }
+
+    // Takes one intersection whose signal turned green since the last call
+    bool takeTurnedGreen(int& intersection) {
+        if(turnedGreen.empty()) return false;
+        intersection = turnedGreen.back();
+        turnedGreen.pop_back();
+        return true;
+    }
+
+void displaySignalStatus(ostream& out = cout) {
+   out << "\nTraffic Signal Status:\n";
+   out << "=====================\n";
+   long now = events->now();                                   //display function (please improve formating later) for signals
+   signals.forEach([&](int intersection, const TrafficSignal* signal) {
+       out << "Intersection " << intersections->name(intersection) << ": "
+            << (signal->isGreen ? GREEN + "GREEN" : RED + "RED") << RESET;
+       if(signal->holds > 0) {
+           out << " (held for emergency vehicle)" << endl;
+           return;
        }
-   }
+       long timeLeft = signal->greenDuration - (now - signal->lastChange);
+       out << " (" << timeLeft << " seconds until change)" << endl;
+   });
 }
 };
 class EmergencyVehicleManager {
 private:
-    HashTable<string, EmergencyVehicle> vehicles;
-    LinkedList<string> vehicleIds;
+    DynamicArray<EmergencyVehicle> vehicles;                      // index is the EMERGENCY_EXIT target
     DirectedWeightedGraph* graph;                                 // class for emergency vehicles
-    HashTable<string, time_t> lastMoveTime;
-    HashTable<string, int> currentSegmentTime;
+    HierarchyBuilder* hierarchies;                                // contraction hierarchy, built off this thread
+    EdgeCostOverlay* costOverlay;                                 // closures the hierarchy doesn't know about
+    SignalManagementSystem* signals;
+    SimEventQueue* events;
+    const SymbolTable* intersections;
+
+    // Intersection at position of the vehicle's path, or -1
+    int intersectionAt(const EmergencyVehicle& v, int position) {
+        Node<int>* pathNode = v.path.head;
+        for(int i = 0; i < position && pathNode; i++) {
+            pathNode = pathNode->next;
+        }
+        return pathNode ? pathNode->data : -1;
+    }
+
+    // Holds the signal at the vehicle's position green while it drives the
+    // road from there, and for high priority the one behind it red
+    void holdSignals(const EmergencyVehicle& v) {
+        signals->hold(intersectionAt(v, v.currentPosition), true);
+        if(v.priority == "High" && v.currentPosition > 0) {
+            signals->hold(intersectionAt(v, v.currentPosition - 1), false);
+        }
+    }
+
+    void releaseSignals(const EmergencyVehicle& v) {
+        signals->release(intersectionAt(v, v.currentPosition));
+        if(v.priority == "High" && v.currentPosition > 0) {
+            signals->release(intersectionAt(v, v.currentPosition - 1));
+        }
+    }
+
+    // Starts the road leaving the vehicle's position and schedules its end.
+    // A vehicle with no road to drive stops: it has arrived if it has a
+    // route (start == end), otherwise its destination is unreachable.
+    void enterSegment(int index) {
+        EmergencyVehicle& v = vehicles[index];
+        int from = intersectionAt(v, v.currentPosition);
+        int to = intersectionAt(v, v.currentPosition + 1);
+        if(from == -1 || to == -1) {
+            v.inTransit = false;
+            return;
+        }
+
+        int currentWeight = graph->getSnapshot().edgeWeight(from, to);
+        if(currentWeight < 0) currentWeight = 0;
+        
+        // Reduce time for emergency vehicles (move faster than regular vehicles)
+        currentWeight = max(1, currentWeight / 2);
 
-    int getIndex(char id) { return id - 'A'; }
-    char getId(int index) { return static_cast<char>('A' + index); }
+        holdSignals(v);
+        events->scheduleIn(currentWeight, SimEvent{SimEvent::EMERGENCY_EXIT, index, 0, 0});
+    }
 
 public:
-    EmergencyVehicleManager(DirectedWeightedGraph* g) : graph(g) {}
+    EmergencyVehicleManager(DirectedWeightedGraph* g, const SymbolTable* names,
+                            SignalManagementSystem* s, SimEventQueue* e)
+        : graph(g), hierarchies(nullptr), costOverlay(nullptr), signals(s), events(e), intersections(names) {}
+
+    void setHierarchyBuilder(HierarchyBuilder* h) { hierarchies = h; }
+    void setCostOverlay(EdgeCostOverlay* o) { costOverlay = o; }
+
+    // Sizes the vehicle array before a bulk load
+    void reserveVehicles(size_t n) { vehicles.reserve(n); }
 
-    void addVehicle(const string& id, char start, char end, const string& priority) {
-        EmergencyVehicle v{id, start, end, priority, LinkedList<char>(), 0, true};
+    void addVehicle(const string& id, int start, int end, const string& priority) {
+        EmergencyVehicle v{id, start, end, priority, LinkedList<int>(), 0, true};
         calculateRoute(v);
-        vehicles.insert(id, v);
-        vehicleIds.insertAtEnd(id);                                   // adding emergency vehicles
+        vehicles.push_back(v);                                        // adding emergency vehicles
+        enterSegment((int)vehicles.size() - 1);
     }
 
-    void calculateRoute(EmergencyVehicle& vehicle) {
-        int path[100];
-        int pathLength = graph->dijkstra(getIndex(vehicle.start), getIndex(vehicle.end), path);
-        
-        for(int i = 0; i < pathLength; i++) {                     //calculating optimal route for emergency vehicles with 
-            vehicle.path.insertAtEnd(getId(path[i]));               // congesion leveles and weights
+    // The contraction hierarchy only knows the road weights: it answers
+    // while it matches them and no road is closed. ALT answers otherwise,
+    // over the live costs, and while a rebuild for new weights is running.
+    int computeRoute(int source, int destination, DynamicArray<int>& path) {
+        if(costOverlay != nullptr && costOverlay->hasClosures()) {
+            return graph->findRoute(source, destination, path, costOverlay->getCosts());
+        }
+        ContractionHierarchy* hierarchy = hierarchies != nullptr ? hierarchies->current() : nullptr;
+        if(hierarchy != nullptr) {
+            return hierarchy->query(source, destination, path);
         }
+        return graph->findRoute(source, destination, path);
     }
 
-       void updatePositions() {
-        Node<string>* current = vehicleIds.head;
-        while(current != nullptr) {
-            EmergencyVehicle v;
-            if(vehicles.get(current->data, v) && v.inTransit) {                         //emergency movement through graph
-                time_t currentTime = time(nullptr);
-                                    
-                // Get current segment weight
-                Node<char>* pathNode = v.path.head;
-                for(int i = 0; i < v.currentPosition && pathNode && pathNode->next; i++) {
-                    pathNode = pathNode->next;
-                }
-                
-                if(pathNode && pathNode->next) {
-                    int currentWeight = 0;
-                    GNode* edges = graph->getEdges(pathNode->data - 'A');
-                    while(edges) {
-                        if(edges->vertex == (pathNode->next->data - 'A')) {
-                            currentWeight = edges->weight;
-                            break;
-                        }
-                        edges = edges->next;
-                    }
-                    
-                    // Reduce time for emergency vehicles (move faster than regular vehicles)
-                    currentWeight = max(1, currentWeight / 2);
-                    
-                    int elapsedTime;
-                    if(!currentSegmentTime.get(v.id, elapsedTime)) {
-                        elapsedTime = 0;
-                        currentSegmentTime.insert(v.id, 0);
-                    }
-                    
-                    if(difftime(currentTime, lastMoveTime[v.id]) >= 1) {
-                        elapsedTime++;
-                        currentSegmentTime.insert(v.id, elapsedTime);
-                        lastMoveTime.insert(v.id, currentTime);
-                        
-                        if(elapsedTime >= currentWeight) {
-                            v.currentPosition++;
-                            currentSegmentTime.insert(v.id, 0);
-                            
-                            if(v.currentPosition >= v.path.countNodes() - 1) {
-                                v.inTransit = false;
-                            }
-                        }
-                        vehicles.insert(current->data, v);
-                    }
-                }
-            }
-            current = current->next;
+    void calculateRoute(EmergencyVehicle& vehicle) {
+        DynamicArray<int> path;
+        int pathLength = computeRoute(vehicle.start, vehicle.end, path);
+
+        for(int i = 0; i < pathLength; i++) {                     //calculating optimal route for emergency vehicles with
+            vehicle.path.insertAtEnd(path[i]);                      // congesion leveles and weights
         }
     }
 
+    // The vehicle reached the end of its road: releases the signals it held
+    // and moves on to the next road, or arrives
+    void onSegmentExit(const SimEvent& event) {
+        EmergencyVehicle& v = vehicles[event.target];                  //emergency movement through graph
+        if(!v.inTransit) return;
+        releaseSignals(v);
+        v.currentPosition++;
+        if(v.currentPosition >= v.path.countNodes() - 1) {
+            v.inTransit = false;
+            return;
+        }
+        enterSegment(event.target);
+    }
 
-    void displayVehicles() {
-        Node<string>* current = vehicleIds.head;                         //display funciton for all vehicles from vehicle file
-        while(current != nullptr) {
-            EmergencyVehicle v;
-            if(vehicles.get(current->data, v)) {
-                cout << "\n" << RED << v.id << " (Priority: " << v.priority << "):" << RESET;
-                if(!v.inTransit) {
-                    cout << " ARRIVED at " << v.end;
-                    current = current->next;
-                    continue;
-                }
+    size_t vehicleCount() const { return vehicles.size(); }
 
-                Node<char>* pathNode = v.path.head;
-                for(int i = 0; i <= v.currentPosition && pathNode; i++) {
-                    if(i < v.currentPosition) {
-                        cout << pathNode->data << " -> ";
-                        pathNode = pathNode->next;
-                    }
-                }
-                if(pathNode && pathNode->next) {
-                    cout << RED << pathNode->data << " -> " << pathNode->next->data << RESET;
-                }
-            }
-            current = current->next;
+    size_t movingVehicles() const {
+        size_t moving = 0;
+        for(size_t i = 0; i < vehicles.size(); i++) {
+            if(vehicles[i].inTransit) moving++;
         }
-        cout << endl;
+        return moving;
     }
 
-    char getCurrentLocation(const EmergencyVehicle& v) {                          //to return current locaiton of vehicle in the graph
-        Node<char>* current = v.path.head;
-        for(int i = 0; i < v.currentPosition && current; i++) {
-            current = current->next;
+    // Vehicles that could not set off because no route reaches their destination
+    size_t unroutableVehicles() const {
+        size_t unroutable = 0;
+        for(size_t i = 0; i < vehicles.size(); i++) {
+            if(vehicles[i].path.head == nullptr) unroutable++;
         }
-        return current ? current->data : v.start;
+        return unroutable;
     }
 
-    void forceSignalOverride(SignalManagementSystem* signals) {
-    Node<string>* current = vehicleIds.head;
-    while(current != nullptr) {
-        EmergencyVehicle v;
-        if(vehicles.get(current->data, v) && v.inTransit) {
-            char location = getCurrentLocation(v);
-            signals->emergencyOverride(location);
-            
-            // For high priority vehicles, turn signal behind them red
-            if(v.priority == "High") {
-                Node<char>* pathNode = v.path.head;
-                for(int i = 0; i < v.currentPosition - 1 && pathNode; i++) {
+
+    void displayVehicles(ostream& out = cout) {
+        for(size_t index = 0; index < vehicles.size(); index++) {        //display funciton for all vehicles from vehicle file
+            const EmergencyVehicle& v = vehicles[index];
+            out << "\n" << RED << v.id << " (Priority: " << v.priority << "):" << RESET;
+            if(v.path.head == nullptr) {
+                out << " NO ROUTE to " << intersections->name(v.end);
+                continue;
+            }
+            if(!v.inTransit) {
+                out << " ARRIVED at " << intersections->name(v.end);
+                continue;
+            }
+
+            Node<int>* pathNode = v.path.head;
+            for(int i = 0; i <= v.currentPosition && pathNode; i++) {
+                if(i < v.currentPosition) {
+                    out << intersections->name(pathNode->data) << " -> ";
                     pathNode = pathNode->next;
                 }
-                
-                if(pathNode && v.currentPosition > 0) {
-                    TrafficSignal* signal;
-                    if(signals->getSignalStatus(pathNode->data, signal)) {
-                        signal->isGreen = false;
-                        signal->lastChange = time(nullptr);
-                    }
-                }
+            }
+            if(pathNode && pathNode->next) {
+                out << RED << intersections->name(pathNode->data) << " -> "
+                     << intersections->name(pathNode->next->data) << RESET;
             }
         }
-        current = current->next;
+        out << endl;
     }
-}
 };
 class VehicleRoutingSystem {
 private:
     DirectedWeightedGraph* graph;
     SignalManagementSystem* signals;
-    HashTable<string, Vehicle> vehicles;
-    HashTable<char, int> congestionLevels;
+    VehicleStore vehicles;                             // per-vehicle state
+    HashTable<string, VehicleHandle> vehicleIndex;     // id -> slot in vehicles
+    HashTable<string, int> arrivals;                   // id -> destination, once its slot is released
     CongestionMonitor congestionMonitor;               //darastructures for vehicle routing
     RoadClosureManager* closureManager;
     TrafficAnalytics* analytics;
+    CustomizableRoutePlanner* planner;                 // live-cost routes instead of ALT, if set
+    static const long PLANNER_BATCH_SECONDS = 30;      // congestion reaches the planner at most this often
+    static const size_t ROUTE_CACHE_BYTES = 1 << 20;
+    ShortestPathTreeCache routeCache;                  // trees shared by trips with a common endpoint
+    EdgeCostOverlay* costOverlay;                      // live cost per edge id (closures, congestion)
+    unsigned long plannerClosureVersion;               // overlay closures the planner was customized for
+    long nextPlannerCustomize;                         // sim second the next congestion batch is due
+    DynamicArray<int> changedEdges;
+    const SymbolTable* intersections;
+    SimEventQueue* events;                             // each moving vehicle has its road exit scheduled
+    DynamicArray<DynamicArray<VehicleHandle>> waitingAt;  // per intersection: vehicles stopped at its red signal
+
+    static const uint32_t NO_PARTNER = UINT32_MAX;
+    HashTable<RoadKey, uint32_t> collisionGroups;      // (current, next) -> moving vehicle on that road
+
+    // One road exit of a batch, as the parallel pass left it
+    struct ExitWork {
+        uint32_t slot = 0;
+        bool valid = false;                            // the vehicle was moving when the batch started
+        int from = -1;                                 // road it just finished
+        int to = -1;
+        int oldEdge = -1;
+        long oldSegmentStart = -1;
+        bool planned = false;                          // path holds its reroute (empty if none found)
+        DynamicArray<int> path;
+    };
+
+    // Roads a worker saw vehicles leave and enter, in batch order
+    struct CongestionDelta {
+        DynamicArray<int> left;
+        DynamicArray<int> entered;
+    };
+
+    static const size_t MIN_EXITS_PER_WORKER = 64;
+    ThreadPool* pool;                                  // splits batches of road exits; null runs them inline
+    DynamicArray<ExitWork> exitWork;
+    DynamicArray<CongestionDelta> workerDeltas;        // one per worker
+    DynamicArray<int> leftCounts;                      // per edge id, while merging a batch
+    DynamicArray<int> enteredCounts;
+    DynamicArray<int> touchedEdges;
 
     struct CollisionEvent {
         string vehicle1;
         string vehicle2;
-        char location;
+        int location;
         time_t timestamp;
     };
-    
-
-    int getIndex(char id) { return id - 'A'; }
-    char getId(int index) { return static_cast<char>('A' + index); }
 
 public:
 
-LinkedList<string> vehicleIds;
-LinkedList<CollisionEvent> collisions;             // linked lists to track vehicle ids and collision events
-   VehicleRoutingSystem(DirectedWeightedGraph* g, SignalManagementSystem* s, TrafficAnalytics* a) 
-        : graph(g), signals(s), analytics(a) {}
+DynamicArray<string> vehicleIds;                   // every id added, in order, for the displays
+LinkedList<CollisionEvent> collisions;             // collision events
+   VehicleRoutingSystem(DirectedWeightedGraph* g, const SymbolTable* names, SignalManagementSystem* s, TrafficAnalytics* a,
+                        SimEventQueue* e)
+        : graph(g), signals(s), closureManager(nullptr), analytics(a), planner(nullptr),
+          routeCache(*g, ROUTE_CACHE_BYTES), costOverlay(nullptr), plannerClosureVersion(ULONG_MAX),
+          nextPlannerCustomize(0), intersections(names),
+          events(e), waitingAt(names->size()), pool(nullptr) {
+        congestionMonitor.setNetwork(g, names);
+    }
+
+    void setPlanner(CustomizableRoutePlanner* p) { planner = p; }
+    void setClosureManager(RoadClosureManager* c) { closureManager = c; }
+    void setThreadPool(ThreadPool* p) { pool = p; }
 
-    HashTable<char, int>& getCongestionLevels() {
-        return congestionLevels;
+    void setCostOverlay(EdgeCostOverlay* o) {
+        costOverlay = o;
+        congestionMonitor.setCostOverlay(o);
     }
 
-    void addVehicle(const string& id, char start, char end) {
-        Vehicle v{id, start, end, LinkedList<char>(), LinkedList<int>(), 0, 0, true};
-        calculateRoute(v);
-        vehicles.insert(id, v);
-        vehicleIds.insertAtEnd(id);
+    // Hands the roads whose cost changed to the planner. Closures and
+    // reopenings are customized in at once; congestion is batched and
+    // customized at most every PLANNER_BATCH_SECONDS, so in between the
+    // planner prices slightly stale penalties.
+    void refreshPlanner(long now) {
+        if(planner == nullptr || costOverlay == nullptr) return;
+        costOverlay->takeChangedEdges(changedEdges);
+        const int* costs = costOverlay->getCosts();
+        for(int i = 0; i < (int)changedEdges.size(); i++) {
+            planner->setEdgeCost(changedEdges[i], costs[changedEdges[i]]);
+        }
+        bool closuresChanged = costOverlay->getClosureVersion() != plannerClosureVersion;
+        if(!closuresChanged && now < nextPlannerCustomize) return;
+        planner->customize();
+        plannerClosureVersion = costOverlay->getClosureVersion();
+        nextPlannerCustomize = now + PLANNER_BATCH_SECONDS;
     }
 
-    void calculateRoute(Vehicle& vehicle) {
-        int path[100];
-        int pathLength = graph->dijkstra(
-            getIndex(vehicle.start),                         //djistra algorithm implementation
-            getIndex(vehicle.end),
-            path
-        );
+    // Points the route cache at the live costs; its trees are dropped once
+    // edge weights changed or a road was closed or reopened since they were
+    // built. Congestion alone keeps them: a vehicle whose road turns out
+    // congested is rerouted when it gets there.
+    void syncRouteCache() {
+        unsigned long version = graph->getVersion() +
+                                (costOverlay != nullptr ? costOverlay->getClosureVersion() : 0);
+        routeCache.setVersion(version);
+        routeCache.setEdgeCosts(costOverlay != nullptr ? costOverlay->getCosts() : nullptr);
+    }
 
-        vehicle.path.clear();
-        vehicle.timings.clear();
+    // Whether the overlay makes road e closed or slower than its weight
+    bool isRoadImpeded(int e) {
+        if(costOverlay == nullptr || e == -1) return false;
+        return costOverlay->getCost(e) != graph->getSnapshot().weight(e);
+    }
 
-        for(int i = 0; i < pathLength; i++) {
-            vehicle.path.insertAtEnd(getId(path[i]));
-            if(i < pathLength - 1) {
-                GNode* edges = graph->getEdges(path[i]);
-                while(edges != nullptr) {
-                    if(edges->vertex == path[i+1]) {
-                        vehicle.timings.insertAtEnd(edges->weight);
-                        break;
-                    }
-                    edges = edges->next;
-                }
-            }
-        }
+    void displayRouteCacheStats(ostream& out = cout) {
+        out << "\nRoute Cache:\n";
+        out << "============\n";
+        out << "Hits: " << routeCache.getHits() << ", misses: " << routeCache.getMisses()
+             << ", evictions: " << routeCache.getEvictions() << "\n";
+        out << "Trees cached: " << routeCache.getNumTrees() << "/" << routeCache.getMaxTrees() << "\n";
     }
-    bool checkCollision(const Vehicle& v1, const Vehicle& v2) {
-        if (!v1.inTransit || !v2.inTransit) return false;
-                                                                          
-        char loc1 = getCurrentLocation(v1);
-        char loc2 = getCurrentLocation(v2);
-        
-        // Check if vehicles are at same intersection
-        if (loc1 == loc2) {
-            Node<char>* path1 = v1.path.head;
-            Node<char>* path2 = v2.path.head;
-            
-            // Move to current positions
-            for (int i = 0; i < v1.currentPosition && path1; i++) path1 = path1->next;
-            for (int i = 0; i < v2.currentPosition && path2; i++) path2 = path2->next;
-            
-            // Check if vehicles are moving to same next intersection
-            if (path1 && path1->next && path2 && path2->next) {
-                if (path1->next->data == path2->next->data) {
-                    CollisionEvent collision{v1.id, v2.id, loc1, time(nullptr)};
-                    collisions.insertAtEnd(collision);
-                    return true;
-                }
-            }
+
+    // Route under the live costs: ALT over the overlay, or the planner when
+    // one was set
+    int computeLiveRoute(int from, int to, DynamicArray<int>& path) {
+        if(planner != nullptr && planner->isCustomized()) {
+            return planner->query(from, to, path);
         }
-        return false;
+        return graph->findRoute(from, to, path,
+                                costOverlay != nullptr ? costOverlay->getCosts() : nullptr);
     }
 
-    void handleCollisions() {
-       //                                                                          Check all vehicle pairs for collisions
-        Node<string>* current1 = vehicleIds.head;
-        while (current1 != nullptr) {
-            Node<string>* current2 = current1->next;
-            while (current2 != nullptr) {
-                Vehicle v1, v2;
-                if (vehicles.get(current1->data, v1) && vehicles.get(current2->data, v2)) {
-                    if (checkCollision(v1, v2)) {
-//                                                                    Stop both vehicles if leaving intersection and joining same new road
-                        v1.inTransit = false;
-                        v2.inTransit = false;
-                        vehicles.insert(v1.id, v1);
-                        vehicles.insert(v2.id, v2);
-                    }
-                }
-                current2 = current2->next;
-            }
-            current1 = current1->next;
+    // Replaces the vehicle's path and segment timings with path, which starts
+    // at the vehicle's current intersection
+    void assignRoute(uint32_t slot, const DynamicArray<int>& path) {
+        vehicles.route(slot).assign(graph->getSnapshot(), path, vehicles.start(slot));
+        vehicles.cursor(slot) = 0;
+        enterSegment(slot);
+    }
+
+    // Loads the location, road and road duration columns for the route
+    // position at the vehicle's cursor. Duration is -1 if there is no road
+    // left to drive.
+    void enterSegment(uint32_t slot) {
+        const Route& route = vehicles.route(slot);
+        int cursor = vehicles.cursor(slot);
+        vehicles.location(slot) = route.intersection(graph->getSnapshot(), cursor);
+        vehicles.currentEdge(slot) = route.edge(cursor);
+        vehicles.segmentDuration(slot) = route.segmentTime(cursor);
+    }
+
+    // Seconds the vehicle has been driving its current road (0 while it waits)
+    int timeOnSegment(uint32_t slot) {
+        long start = vehicles.segmentStart(slot);
+        if(start < 0) return 0;
+        long spent = events->now() - start;
+        return (int)min(spent, (long)vehicles.segmentDuration(slot));
+    }
+
+    // Seconds until the vehicle reaches its destination
+    int remainingTime(uint32_t slot) {
+        return vehicles.route(slot).remainingTime(vehicles.cursor(slot), timeOnSegment(slot));
+    }
+
+    // Intersection the vehicle drives to next, or -1
+    int nextLocation(uint32_t slot) {
+        int e = vehicles.currentEdge(slot);
+        return e == -1 ? -1 : graph->getSnapshot().target(e);
+    }
+
+    // Sizes the vehicle columns and id tables before a bulk load
+    void reserveVehicles(size_t n) {
+        vehicles.reserve(n);
+        vehicleIndex.reserve(n);
+        vehicleIds.reserve(n);
+    }
+
+    void addVehicle(const string& id, int start, int end) {
+        VehicleHandle* existing = vehicleIndex.find(id);
+        if(existing == nullptr) {
+            vehicleIds.push_back(id);
+        } else if(vehicles.isValid(*existing)) {
+            leaveCollisionGroup(existing->slot);
+            vehicles.release(existing->slot);               // same id again replaces the trip
         }
+        arrivals.remove(id);
+        VehicleHandle handle = vehicles.add(id, start, end);
+        calculateRoute(handle.slot);
+        vehicleIndex.insert(id, handle);
+        joinCollisionGroup(handle.slot);
+        if(vehicles.isInTransit(handle.slot)) depart(handle.slot);
     }
-    void handleCollision(const Vehicle& v1, const Vehicle& v2, char location) {
-        Node<char>* path1 = v1.path.head;
-        Node<char>* path2 = v2.path.head;
-        analytics->recordAccident();
-        
-        for(int i = 0; i < v1.currentPosition && path1; i++) path1 = path1->next;
-        for(int i = 0; i < v2.currentPosition && path2; i++) path2 = path2->next;          //update road path to blocked for 10 second upon collision
-                   
-        if(path1 && path1->next && path2 && path2->next) {
-            string roadKey1 = string(1, location) + "-" + string(1, path1->next->data);
-            string roadKey2 = string(1, location) + "-" + string(1, path2->next->data);
-            
-            closureManager->addClosure(roadKey1, "Blocked");
-            closureManager->addClosure(roadKey2, "Blocked");
-            
-            Vehicle v1Copy = v1;
-            Vehicle v2Copy = v2;
-            v1Copy.inTransit = false;
-            v2Copy.inTransit = false;
-            vehicles.insert(v1.id, v1Copy);
-            vehicles.insert(v2.id, v2Copy);
-            
-            CollisionEvent collision{v1.id, v2.id, location, time(nullptr)};
-            collisions.insertAtEnd(collision);
+
+    void calculateRoute(uint32_t slot) {
+        DynamicArray<int> path;
+        syncRouteCache();
+        routeCache.route(
+            vehicles.start(slot),                            //shortest-path tree shared with other trips
+            vehicles.end(slot),
+            path
+        );
+        assignRoute(slot, path);
+    }
+    // Two moving vehicles on the same road (same current and next
+    // intersection) collide, and both stop. Each road keeps the one moving
+    // vehicle on it that has not collided yet; a vehicle joining the road
+    // collides with it. Vehicles join when they get a new road, so the
+    // vehicles loaded together pair off in slot order, as a scan over every
+    // pair would.
+    void joinCollisionGroup(uint32_t slot) {
+        int next = nextLocation(slot);
+        if (!vehicles.isInTransit(slot) || next == -1) return;
+        pair<uint32_t*, bool> waiting =
+            collisionGroups.try_emplace(makeRoadKey(vehicles.location(slot), next), slot);
+        if (waiting.second) return;                            // first on its road
+        if (*waiting.first == NO_PARTNER) {
+            *waiting.first = slot;
+            return;
         }
+        uint32_t partner = *waiting.first;
+        *waiting.first = NO_PARTNER;
+        CollisionEvent collision{vehicles.id(partner), vehicles.id(slot), vehicles.location(slot), events->getClock().calendarNow()};
+        collisions.insertAtEnd(collision);
+        analytics->recordAccident();
+//                                                                    Stop both vehicles if leaving intersection and joining same new road
+        vehicles.setInTransit(partner, false);
+        vehicles.setInTransit(slot, false);
     }
 
-    void displayCollisions() {
+    void leaveCollisionGroup(uint32_t slot) {
+        leaveCollisionGroup(slot, vehicles.location(slot), nextLocation(slot));
+    }
+
+    // Leaves the group of road (from, next), which need not be the vehicle's current road
+    void leaveCollisionGroup(uint32_t slot, int from, int next) {
+        if (next == -1) return;
+        uint32_t* waiting = collisionGroups.find(makeRoadKey(from, next));
+        if (waiting != nullptr && *waiting == slot) *waiting = NO_PARTNER;
+    }
+
+    void displayCollisions(ostream& out = cout) {
         if (collisions.head == nullptr) {                                //fucntion to print collisions along with their time
-            cout << "\nNo collisions reported.\n";
+            out << "\nNo collisions reported.\n";
             return;
         }
         
-        cout << "\nCollision Reports:\n";
-        cout << "=================\n";
+        out << "\nCollision Reports:\n";
+        out << "=================\n";
         Node<CollisionEvent>* current = collisions.head;
         while (current != nullptr) {
-            cout << RED << "Collision between " << current->data.vehicle1 
+            out << RED << "Collision between " << current->data.vehicle1 
                  << " and " << current->data.vehicle2
-                 << " at intersection " << current->data.location 
+                 << " at intersection " << intersections->name(current->data.location) 
                  << " (Time: " << ctime(&current->data.timestamp) << ")" << RESET;
             current = current->next;
         }
     }
 
-    void checkAndUpdateRoute(const string& id) {
-    Vehicle v;
-    if(vehicles.get(id, v) && v.inTransit) {
-        // Get current location and check surrounding roads
-        char currentLoc = getCurrentLocation(v);
-        Node<char>* pathNode = v.path.head;
-        
-        // Move to current position
-        for(int i = 0; i < v.currentPosition && pathNode && pathNode->next; i++) {
-            pathNode = pathNode->next;
-        }
-        
-        // Check if next road segment is blocked or congested
-        if(pathNode && pathNode->next) {
-            if(closureManager->isRoadBlocked(pathNode->data, pathNode->next->data) || 
-               congestionMonitor.isRoadCongested(pathNode->data, pathNode->next->data)) {
-                
-                // Calculate new path from current location
-                int newPath[100];
-                int newPathLength = graph->dijkstra(
-                    currentLoc - 'A',
-                    v.end - 'A',
-                    newPath
-                );
-                
-                // Update vehicle's path
-                v.path.clear();
-                v.timings.clear();
-                for(int i = 0; i < newPathLength; i++) {
-                    v.path.insertAtEnd(getId(newPath[i]));
-                }
-                v.currentPosition = 0;
-                calculateRoute(v);
-                vehicles.insert(id, v);
-            }
-        }
-    }
-}
-
-    string makeRoadKey(char start, char end) {                               //to beautify display making keys for all neccesary things
-    return string(1, start) + "-" + string(1, end);
+    RoadKey makeRoadKey(int start, int end) {                               //to beautify display making keys for all neccesary things
+    return RoadKey(start, end);
 }
 
-void displayVehiclesPerRoad() {
-    HashTable<string, int> roadCount;
+void displayVehiclesPerRoad(ostream& out = cout) {
+    HashTable<RoadKey, int> roadCount;
     
     // Count vehicles on each road segment
-    Node<string>* current = vehicleIds.head;
-    while(current != nullptr) {
-        Vehicle v;
-        if(vehicles.get(current->data, v) && v.inTransit) {
-            Node<char>* pathNode = v.path.head;
-            // Move to current position in path
-            for(int i = 0; i < v.currentPosition && pathNode && pathNode->next; i++) {
-                pathNode = pathNode->next;
-            }
-            
-            // If vehicle is on a road segment
-            if(pathNode && pathNode->next) {
-                string roadKey = makeRoadKey(pathNode->data, pathNode->next->data);
-                int count = 0;
-                roadCount.get(roadKey, count);
-                roadCount.insert(roadKey, count + 1);
-            }
+    for(uint32_t slot = 0; slot < vehicles.slotCount(); slot++) {
+        int next = nextLocation(slot);
+        if(vehicles.isInTransit(slot) && next != -1) {
+            RoadKey roadKey = makeRoadKey(vehicles.location(slot), next);
+            int count = 0;
+            roadCount.get(roadKey, count);
+            roadCount.insert(roadKey, count + 1);
         }
-        current = current->next;
     }
     
     // Display counts
-    cout << "\nCurrent Vehicle Distribution on Roads:\n";
-    cout << "===================================\n";
-    for(char start = 'A'; start <= 'Z'; start++) {
-        for(char end = 'A'; end <= 'Z'; end++) {
-            string roadKey = makeRoadKey(start, end);
-            int count = 0;
-            if(roadCount.get(roadKey, count) && count > 0) {
-                cout << start << " -> " << end << ": ";
-                if(count >= 3) {
-                    cout << RED << count << " vehicles (CONGESTED)" << RESET;
-                } else {
-                    cout << GREEN << count << " vehicles" << RESET;
-                }
-                cout << endl;
-            }
+    out << "\nCurrent Vehicle Distribution on Roads:\n";
+    out << "===================================\n";
+    roadCount.forEach([&](const RoadKey& roadKey, int count) {
+        out << intersections->name(roadKey.from()) << " -> " << intersections->name(roadKey.to()) << ": ";
+        if(count >= 3) {
+            out << RED << count << " vehicles (CONGESTED)" << RESET;
+        } else {
+            out << GREEN << count << " vehicles" << RESET;
         }
-    }
+        out << endl;
+    });
 }
     
 
-    void updateAllVehicles() {
-         handleCollisions(); 
-        Node<string>* current = vehicleIds.head;
-        while(current != nullptr) {
-            updateVehiclePosition(current->data);
-            current = current->next;
-        }
-    }
-
-    void updateVehiclePosition(const string& id) {
-        Vehicle v;
-        if(vehicles.get(id, v)) {
-            if(!v.inTransit) return;
-
-            // Get current signal status
-            TrafficSignal* signal;
-            char currentLocation = getCurrentLocation(v);
-            
-            // Check for congestion and reroute if needed
-            Node<char>* pathNode = v.path.head;
-            for(int i = 0; i < v.currentPosition && pathNode && pathNode->next; i++) {
-                pathNode = pathNode->next;
+    // Sends the vehicle onto the road at its cursor. It is rerouted first if
+    // that road is now closed or congested, and waits for the green if the
+    // signal where it stands is red; otherwise its exit at the road's end is
+    // scheduled. plannedPath, if given, is the live route already looked up
+    // for the vehicle from where it stands.
+    void depart(uint32_t slot, const DynamicArray<int>* plannedPath = nullptr) {
+        TrafficSignal* signal;
+        int currentLocation = vehicles.location(slot);
+        
+        // Check for congestion and reroute if needed
+        if(isRoadImpeded(vehicles.currentEdge(slot))) {
+            // The live route already prices the closure or congestion in; only switch
+            // if it picks a different next road
+            DynamicArray<int> computedPath;
+            const DynamicArray<int>* newPath = plannedPath;
+            if(newPath == nullptr) {
+                computeLiveRoute(currentLocation, vehicles.end(slot), computedPath);
+                newPath = &computedPath;
             }
-            
-            if(pathNode && pathNode->next) {
-                if(congestionMonitor.isRoadCongested(pathNode->data, pathNode->next->data)) {
-                    LinkedList<char> newPath = congestionMonitor.findAlternativeRoute(
-                        graph, 
-                        currentLocation, 
-                        v.end
-                    );
-                    if(newPath.head != nullptr) {
-                        congestionMonitor.decreaseCongestion(v.path, v.currentPosition);
-                        v.path = newPath;
-                        v.currentPosition = 0;
-                        calculateRoute(v);
-                    }
-                }
+            if(newPath->size() > 1 && (*newPath)[1] != nextLocation(slot)) {
+                leaveCollisionGroup(slot);
+                congestionMonitor.decreaseCongestion(vehicles.currentEdge(slot));
+                assignRoute(slot, *newPath);
+                congestionMonitor.updateCongestion(vehicles.currentEdge(slot));
+                joinCollisionGroup(slot);
+                if(!vehicles.isInTransit(slot)) return;
             }
+        }
 
-            if(signals->getSignalStatus(currentLocation, signal)) {
-                if(!signal->isGreen) {
-                    return;
-                }
+        if(signals->getSignalStatus(currentLocation, signal)) {
+            if(!signal->isGreen) {
+                vehicles.segmentStart(slot) = -1;
+                waitingAt[currentLocation].push_back(vehicles.handleOf(slot));
+                return;
             }
+        }
+
+        int duration = vehicles.segmentDuration(slot);
+        if(duration < 0) {                                       // no route to its destination
+            vehicles.setInTransit(slot, false);
+            return;
+        }
+        vehicles.segmentStart(slot) = events->now();
+        events->scheduleIn(duration, SimEvent{SimEvent::VEHICLE_EXIT, (int)slot, 0, vehicles.handleOf(slot).generation});
+    }
 
-            v.timeInCurrentSegment++;
-            Node<int>* timingNode = v.timings.head;
-            for(int i = 0; i < v.currentPosition; i++) {
-                if(timingNode) timingNode = timingNode->next;
+    // The signal at intersection turned green: vehicles waiting there set off
+    void releaseWaiting(int intersection) {
+        if(intersection < 0 || intersection >= (int)waitingAt.size()) return;
+        DynamicArray<VehicleHandle> waiting = std::move(waitingAt[intersection]);
+        for(size_t i = 0; i < waiting.size(); i++) {
+            uint32_t slot = waiting[i].slot;
+            if(vehicles.isValid(waiting[i]) && vehicles.isInTransit(slot) &&
+               vehicles.location(slot) == intersection && vehicles.segmentStart(slot) < 0) {
+                depart(slot);
             }
+        }
+    }
 
-            if(timingNode && v.timeInCurrentSegment >= timingNode->data) {
-                congestionMonitor.decreaseCongestion(v.path, v.currentPosition);
-                v.timeInCurrentSegment = 0;
-                v.currentPosition++;
-                if(v.currentPosition < v.path.countNodes() - 1) {
-                    congestionMonitor.updateCongestion(v.path, v.currentPosition);
-                }
-                if(v.currentPosition >= v.path.countNodes() - 1) {
-                    v.inTransit = false;
-                     analytics->recordVehicleCompletion(v, v.timeInCurrentSegment > timingNode->data);
-                }
-                analytics->recordIntersectionLoad(currentLocation);
+    // A batch of vehicles reached the ends of their roads in the same
+    // second. A parallel pass moves each onto its next road, touching only
+    // its own slot, records per worker the roads left and entered, and looks
+    // up a reroute if the new road is closed or congested (the live costs do
+    // not change within a batch). The congestion counts are then merged and
+    // the order-dependent rest - collisions, analytics, arrival, departure -
+    // runs exit by exit in event order. The outcome is the same for any
+    // number of threads.
+    void onSegmentExits(const DynamicArray<SimEvent>& batch) {
+        size_t n = batch.size();
+        if(exitWork.size() < n) exitWork.resize(n);
+        int workers = pool != nullptr ? pool->size() : 1;
+        if((int)workerDeltas.size() < workers) workerDeltas.resize(workers);
+        for(int w = 0; w < workers; w++) {
+            workerDeltas[w].left.clear();
+            workerDeltas[w].entered.clear();
+        }
+
+        graph->getSnapshot();                              // rebuilt here if stale, never by a worker
+        auto advance = [&](size_t begin, size_t end, int worker) {
+            for(size_t i = begin; i < end; i++) {
+                advanceVehicle(batch[i], exitWork[i], workerDeltas[worker]);
             }
-            vehicles.insert(id, v);
+        };
+        if(pool != nullptr) pool->parallelFor(n, MIN_EXITS_PER_WORKER, advance);
+        else advance(0, n, 0);
+
+        mergeCongestion(workers);
+        for(size_t i = 0; i < n; i++) {
+            finishSegmentExit(exitWork[i]);
         }
     }
 
-    void updateCongestionLevels(const Vehicle& v) {
-        char currentLocation = getCurrentLocation(v);
-        int count;
-        if(congestionLevels.get(currentLocation, count)) {                //after vehicles have moved reclassify the congesion levels
-            congestionLevels.insert(currentLocation, count + 1);
-        } else {
-            congestionLevels.insert(currentLocation, 1);
+    // Parallel part of a road exit; reads shared state, writes only the
+    // vehicle's slot, work and the worker's delta
+    void advanceVehicle(const SimEvent& event, ExitWork& work, CongestionDelta& delta) {
+        uint32_t slot = (uint32_t)event.target;
+        work.slot = slot;
+        work.planned = false;
+        work.valid = vehicles.isValid(VehicleHandle(slot, event.generation)) && vehicles.isInTransit(slot);
+        if(!work.valid) return;
+
+        work.from = vehicles.location(slot);
+        work.to = nextLocation(slot);
+        work.oldEdge = vehicles.currentEdge(slot);
+        work.oldSegmentStart = vehicles.segmentStart(slot);
+        vehicles.segmentStart(slot) = -1;
+        vehicles.cursor(slot)++;
+        enterSegment(slot);
+
+        if(work.oldEdge != -1) delta.left.push_back(work.oldEdge);
+        int e = vehicles.currentEdge(slot);
+        if(e == -1) return;
+        delta.entered.push_back(e);
+        if(isRoadImpeded(e)) {
+            work.planned = true;
+            if(computeLiveRoute(vehicles.location(slot), vehicles.end(slot), work.path) <= 1) work.path.clear();
         }
     }
 
-    char getCurrentLocation(const Vehicle& v) {
-        Node<char>* current = v.path.head;
-        for(int i = 0; i < v.currentPosition && current; i++) {                              //current locatio of vehicle in the graph
-            current = current->next;
+    // Adds up the workers' deltas and applies each road's net change once.
+    // Workers hold consecutive parts of the batch, so roads are first
+    // touched in batch order.
+    void mergeCongestion(int workers) {
+        size_t numEdges = graph->getSnapshot().getNumEdges();
+        if(leftCounts.size() < numEdges) {
+            leftCounts.resize(numEdges, 0);
+            enteredCounts.resize(numEdges, 0);
+        }
+        touchedEdges.clear();
+        for(int w = 0; w < workers; w++) {
+            const CongestionDelta& delta = workerDeltas[w];
+            for(size_t i = 0; i < delta.left.size(); i++) {
+                int e = delta.left[i];
+                if(leftCounts[e] == 0 && enteredCounts[e] == 0) touchedEdges.push_back(e);
+                leftCounts[e]++;
+            }
+            for(size_t i = 0; i < delta.entered.size(); i++) {
+                int e = delta.entered[i];
+                if(leftCounts[e] == 0 && enteredCounts[e] == 0) touchedEdges.push_back(e);
+                enteredCounts[e]++;
+            }
+        }
+        for(size_t i = 0; i < touchedEdges.size(); i++) {
+            int e = touchedEdges[i];
+            congestionMonitor.adjustCongestion(e, leftCounts[e], enteredCounts[e]);
+            leftCounts[e] = 0;
+            enteredCounts[e] = 0;
         }
-        return current ? current->data : v.start;
     }
 
-    void displayVehicles() {
-        Node<string>* current = vehicleIds.head;
-        while(current != nullptr) {                                            //funciton to display behicles in the main 
-            displayVehicleStatus(current->data);
-            current = current->next;
+    // Sequential part of a road exit: the vehicle either arrives or sets
+    // off on its next road
+    void finishSegmentExit(const ExitWork& work) {
+        if(!work.valid) return;
+        uint32_t slot = work.slot;
+        if(!vehicles.isInTransit(slot)) {
+            // A vehicle earlier in the batch collided with it while it was
+            // still on its old road; it stays there
+            int entered = vehicles.currentEdge(slot);
+            vehicles.cursor(slot)--;
+            enterSegment(slot);
+            vehicles.segmentStart(slot) = work.oldSegmentStart;
+            congestionMonitor.decreaseCongestion(entered);
+            congestionMonitor.updateCongestion(work.oldEdge);
+            return;
         }
-        cout << "\n";
-        congestionMonitor.displayCongestionLevels();
+
+        leaveCollisionGroup(slot, work.from, work.to);
+        bool arrived = vehicles.currentEdge(slot) == -1;
+        if(arrived) {
+            // Exits run on schedule, so a trip is never late on the road itself
+            analytics->recordVehicleCompletion(vehicles.start(slot), vehicles.end(slot),
+                                               vehicles.route(slot).totalTime(), false);
+        }
+        analytics->recordIntersectionLoad(work.from);
+        if(arrived) {
+            arrive(slot);
+            return;
+        }
+        joinCollisionGroup(slot);
+        if(vehicles.isInTransit(slot)) depart(slot, work.planned ? &work.path : nullptr);
     }
 
+    // Releases an arrived vehicle's slot, keeping its destination for the displays
+    void arrive(uint32_t slot) {
+        arrivals.insert(vehicles.id(slot), vehicles.end(slot));
+        vehicles.release(slot);
+    }
 
-    void displayVehicleStatus(const string& id) {
-        Vehicle v;                                                         //check if vehicle has arrived at destination or is curreently moving
-        if(vehicles.get(id, v)) {
-            cout << "\nVehicle " << id << ":\n";
-            
-            if(!v.inTransit && v.currentPosition >= v.path.countNodes() - 1) {
-                cout << "Status: ARRIVED at destination " << v.end << "\n";
-                return;
-            }
+    // Vehicles driving or waiting at a signal; the rest stopped after a
+    // collision or for lack of a route
+    size_t movingVehicles() const { return vehicles.movingCount(); }
+    size_t stoppedVehicles() const { return vehicles.size() - vehicles.movingCount(); }
+    size_t arrivedVehicles() const { return arrivals.getSize(); }
 
-            Node<char>* pathNode = v.path.head;
-            Node<int>* timingNode = v.timings.head;
-            
-            for(int i = 0; i <= v.currentPosition && pathNode; i++) {
-                if(i < v.currentPosition) {
-                    cout << pathNode->data << " -> ";
-                    pathNode = pathNode->next;
-                    if(timingNode) timingNode = timingNode->next;
-                }
+    void displayVehicles(ostream& out = cout) {
+        for(size_t i = 0; i < vehicleIds.size(); i++) {                        //funciton to display behicles in the main 
+            displayVehicleStatus(vehicleIds[i], out);
+        }
+        out << "\n";
+        congestionMonitor.displayCongestionLevels(out);
+    }
+
+
+    void displayVehicleStatus(const string& id, ostream& out = cout) {
+        VehicleHandle handle;                                              //check if vehicle has arrived at destination or is curreently moving
+        int destination;
+        if(vehicleIndex.get(id, handle) && vehicles.isValid(handle)) {
+            uint32_t slot = handle.slot;
+            out << "\nVehicle " << id << ":\n";
+
+            const CSRGraph& csr = graph->getSnapshot();
+            const Route& route = vehicles.route(slot);
+            for(int i = 0; i < vehicles.cursor(slot); i++) {
+                out << intersections->name(route.intersection(csr, i)) << " -> ";
             }
             
-            if(pathNode && pathNode->next) {
-                cout << RED << pathNode->data << " -> " << pathNode->next->data << RESET;
-                if(timingNode) {
-                    cout << " (" << v.timeInCurrentSegment << "/" << timingNode->data << " seconds)";
-                }
+            int next = nextLocation(slot);
+            if(next != -1) {
+                out << RED << intersections->name(vehicles.location(slot)) << " -> "
+                     << intersections->name(next) << RESET;
+                out << " (" << timeOnSegment(slot) << "/" << vehicles.segmentDuration(slot) << " seconds, "
+                     << remainingTime(slot) << " to destination)";
             }
+        } else if(arrivals.get(id, destination)) {
+            out << "\nVehicle " << id << ":\n";
+            out << "Status: ARRIVED at destination " << intersections->name(destination) << "\n";
         }
     }
 };
 
+const uint32_t VehicleRoutingSystem::NO_PARTNER;
+
+// The menu views as the simulation thread last rendered them. The UI
+// thread only ever prints these, never the live structures.
+struct DisplaySnapshot {
+    static const int NUM_VIEWS = 8;             // menu choices 1-8, in order
+    unsigned long version;                      // 0 until the first publish
+    long time;                                  // simulated second shown
+    string views[NUM_VIEWS];
+
+    DisplaySnapshot() : version(0), time(0) {}
+};
+
 class CityTrafficSystem {
 public:
     DirectedWeightedGraph* graph;
@@ -971,35 +1214,46 @@ public:
     EmergencyVehicleManager* emergencyManager;
     RoadClosureManager* closureManager;
     TrafficAnalytics* analytics;
+    HierarchyBuilder* hierarchies;              // emergency routes; contracted while the rest loads
+    CustomizableRoutePlanner* planner;          // only with usePlanner; ALT answers live routes otherwise
+    bool usePlanner;
+    EdgeCostOverlay* costOverlay;
+    SimClock clock;                             // simulated time; only the event queue moves it
+    SimEventQueue events;                       // road exits, signal changes and repairs, by simulated second
+    unsigned long eventsProcessed;
+    DynamicArray<SimEvent> exitBatch;           // road exits due together, handed to the router at once
+    ThreadPool* pool;                           // workers for the router's exit batches
+    TripleBuffer<DisplaySnapshot> snapshots;    // simulation thread -> UI thread
+    unsigned long snapshotVersion;
+    static const size_t COMMAND_CAPACITY = 1024;
+    CommandQueue<SimCommand> commands;          // operator actions -> simulation thread
+
+    bool submit(SimCommand::Type type, int from, int to, const string& text) {
+        SimCommand command;
+        if(text.size() >= SimCommand::TEXT_SIZE) return false;
+        command.type = type;
+        command.from = from;
+        command.to = to;
+        text.copy(command.text, text.size());
+        command.text[text.size()] = '\0';
+        return commands.tryPush(command);
+    }
 
-    int getIndex(char id) { return id - 'A'; }
-    char getId(int index) { return static_cast<char>('A' + index); }
-
-    void calculateNumIntersections(const string& filename) {
-        ifstream file(filename);                                          //calculating number of intersections in the file
-        if (!file.is_open()) {
-            cerr << "Failed to open file: " << filename << endl;
-            return;
-        }
-
-        string line;
-        char maxIntersection = 'A';
-        
-        while (getline(file, line)) {
-            if (line.empty()) continue;
-
-            stringstream ss(line);
-            string from, to;
-            if (getline(ss, from, ',') && getline(ss, to, ',')) {
-                maxIntersection = max(maxIntersection, from[0]);
-                maxIntersection = max(maxIntersection, to[0]);
+    // Carries out the operator actions queued since the last step, in the
+    // order they were queued
+    void applyCommands() {
+        SimCommand command;
+        while(commands.tryPop(command)) {
+            switch(command.type) {
+                case SimCommand::SIGNAL_OVERRIDE: signalManager->emergencyOverride(command.from); break;
+                case SimCommand::ROAD_CLOSURE:    closureManager->addClosure(command.from, command.to, command.text); break;
+                case SimCommand::ADD_VEHICLE:     router->addVehicle(command.text, command.from, command.to); break;
             }
         }
-        
-        numIntersections = getIndex(maxIntersection) + 1;
-        file.close();
     }
-    
+    SymbolTable intersections;                  // intersection name <-> vertex id
+    const int LANDMARK_COUNT = 8;               // ALT landmarks for goal-directed routing
+
     void loadRoadNetwork(const string& filename) {
         ifstream file(filename);
         if (!file.is_open()) {
@@ -1007,7 +1261,15 @@ public:
             return;
         }
         
+        struct RoadRecord {
+            int from;
+            int to;
+            int weight;
+        };
+        DynamicArray<RoadRecord> roads;           // the graph is sized once every name is known
+
         string line;
+        bool firstLine = true;
         while (getline(file, line)) {
             if (line.empty()) continue;
             
@@ -1015,15 +1277,38 @@ public:
             string from, to, weight;
             
             if (getline(ss, from, ',') && getline(ss, to, ',') && getline(ss, weight, ',')) {
+                // A header row names the columns: its weight has no digits
+                bool isHeader = firstLine && weight.find_first_of("0123456789") == string::npos;
+                firstLine = false;
+                if (isHeader) continue;
                 try {
                     int w = stoi(weight);
-                    graph->addEdge(getIndex(from[0]), getIndex(to[0]), w);
+                    roads.push_back(RoadRecord{intersections.intern(from), intersections.intern(to), w});
                 } catch(const exception& e) {
                     cerr << "Error parsing line: " << line << endl;
                 }
             }
         }
         file.close();
+
+        numIntersections = intersections.size();
+        graph = new DirectedWeightedGraph(numIntersections);
+        for (size_t i = 0; i < roads.size(); i++) {
+            graph->addEdge(roads[i].from, roads[i].to, roads[i].weight);
+        }
+        graph->getSnapshot();   // build the CSR snapshot once the topology is loaded
+    }
+
+    // Number of non-empty lines in file, which is rewound afterwards
+    size_t countRecords(ifstream& file) {
+        size_t count = 0;
+        string line;
+        while (getline(file, line)) {
+            if (!line.empty()) count++;
+        }
+        file.clear();
+        file.seekg(0);
+        return count;
     }
 
     void loadVehicles(const string& filename) {
@@ -1032,6 +1317,7 @@ public:
             cerr << "Failed to open file: " << filename << endl;
             return;
         }
+        router->reserveVehicles(countRecords(file));
         
         string line;
         while (getline(file, line)) {
@@ -1041,8 +1327,11 @@ public:
             string id, start, end;
             
             if (getline(ss, id, ',') && getline(ss, start, ',') && getline(ss, end, ',')) {
+                int from = intersections.find(start);
+                int to = intersections.find(end);
+                if (from == -1 || to == -1) continue;        // header row or unknown intersection
                 try {
-                    router->addVehicle(id, start[0], end[0]);
+                    router->addVehicle(id, from, to);
                 } catch(const exception& e) {
                     cerr << "Error adding vehicle: " << line << endl;
                 }
@@ -1057,6 +1346,7 @@ public:
         cerr << "Failed to open file: " << filename << endl;
         return;
     }
+    emergencyManager->reserveVehicles(countRecords(file));
     
     string line;
     while (getline(file, line)) {
@@ -1067,7 +1357,10 @@ public:
         
         if (getline(ss, id, ',') && getline(ss, start, ',') && 
             getline(ss, end, ',') && getline(ss, priority, ',')) {
-            emergencyManager->addVehicle(id, start[0], end[0], priority);
+            int from = intersections.find(start);
+            int to = intersections.find(end);
+            if (from == -1 || to == -1) continue;            // header row or unknown intersection
+            emergencyManager->addVehicle(id, from, to, priority);
         }
     }
     file.close();
@@ -1089,8 +1382,10 @@ public:
             string intersection, greenTime;
             
             if (getline(ss, intersection, ',') && getline(ss, greenTime, ',')) {
+                int id = intersections.find(intersection);
+                if (id == -1) continue;                      // header row or unknown intersection
                 try {
-                    signalManager->addSignal(intersection[0], stoi(greenTime));
+                    signalManager->addSignal(id, stoi(greenTime));
                 } catch(const exception& e) {
                     cerr << "Error adding signal: " << line << endl;
                 }
@@ -1100,88 +1395,200 @@ public:
     }
 
 public:                      //consturctor for city class
-    CityTrafficSystem() : graph(nullptr), numIntersections(0), router(nullptr), signalManager(nullptr), emergencyManager(nullptr), analytics(nullptr) {
-        analytics = new TrafficAnalytics();
+    explicit CityTrafficSystem(int threads = 0, bool withPlanner = false) : graph(nullptr), numIntersections(0), router(nullptr), signalManager(nullptr), emergencyManager(nullptr), closureManager(nullptr), analytics(nullptr), hierarchies(nullptr), planner(nullptr), usePlanner(withPlanner), costOverlay(nullptr), events(clock), eventsProcessed(0), pool(nullptr), snapshotVersion(0), commands(COMMAND_CAPACITY) {
+        analytics = new TrafficAnalytics(&intersections, &clock);
+        pool = new ThreadPool(threads);
     }
     
     ~CityTrafficSystem() {
+        delete hierarchies;
         delete graph;
         delete router;                                                 //destory objects after they have been used
         delete signalManager;
         delete emergencyManager;
+        delete closureManager;
         delete analytics;
+        delete planner;
+        delete costOverlay;
+        delete pool;
     }
 
     
        void initializeFromFile(const string& filename) {
-    calculateNumIntersections(filename);
-    cout << "Number of intersections: " << numIntersections << endl;
-    graph = new DirectedWeightedGraph(numIntersections);
     loadRoadNetwork(filename);
-    signalManager = new SignalManagementSystem();
+    if (graph == nullptr) graph = new DirectedWeightedGraph(0);
+    cout << "Number of intersections: " << numIntersections << endl;
+    hierarchies = new HierarchyBuilder(*graph);
+    hierarchies->start();                   // contracts on a worker while the rest loads
+    graph->precomputeLandmarks(LANDMARK_COUNT);
+    if (usePlanner) {
+        planner = new CustomizableRoutePlanner(*graph);
+        planner->customize(nullptr);
+    }
+    costOverlay = new EdgeCostOverlay(*graph);
+    signalManager = new SignalManagementSystem(&intersections, &events);
     loadTrafficSignals("traffic_signals.csv");
-   router = new VehicleRoutingSystem(graph, signalManager, analytics);
-    emergencyManager = new EmergencyVehicleManager(graph); // initializeing all files by calling there functions
+   router = new VehicleRoutingSystem(graph, &intersections, signalManager, analytics, &events);
+    emergencyManager = new EmergencyVehicleManager(graph, &intersections, signalManager, &events);  // initializeing all files by calling there functions
+    router->setPlanner(planner);
+    router->setCostOverlay(costOverlay);
+    router->setThreadPool(pool);
+    emergencyManager->setHierarchyBuilder(hierarchies);
+    emergencyManager->setCostOverlay(costOverlay);
     loadVehicles("vehicles.csv");
+    hierarchies->wait();                    // still load time: emergency routes come from the hierarchy
     loadEmergencyVehicles("emergency_vehicles.csv");
-    closureManager = new RoadClosureManager(graph);
+    closureManager = new RoadClosureManager(&intersections, &events, costOverlay);
     closureManager->loadClosures("road_closures.csv");
+    router->setClosureManager(closureManager);
     
 }
 
-    void displayNetwork() {
+    void displayNetwork(ostream& out = cout) {
         if (!graph) {
-            cout << "Network not initialized!" << endl;
+            out << "Network not initialized!" << endl;
             return;
         }                                                                //display for graph network
 
-        cout << "\nCity Traffic Network Structure:" << endl;
-        cout << "================================" << endl;
+        out << "\nCity Traffic Network Structure:" << endl;
+        out << "================================" << endl;
 
         for (int i = 0; i < numIntersections; i++) {
-            char intersection = getId(i);
-            cout << "\nIntersection " << intersection << " connects to:" << endl;
-
-            GNode* current = graph->getEdges(i);
-            while (current != nullptr) {
-                char toIntersection = getId(current->vertex);
-                cout << "  -> " << toIntersection 
-                     << " (Travel time: " << current->weight << " seconds)" << endl;
-                current = current->next;
+            out << "\nIntersection " << intersections.name(i) << " connects to:" << endl;
+
+            const CSRGraph& csr = graph->getSnapshot();
+            for (int e = csr.edgeBegin(i); e < csr.edgeEnd(i); e++) {
+                out << "  -> " << intersections.name(csr.target(e)) 
+                     << " (Travel time: " << csr.weight(e) << " seconds)" << endl;
             }
         }
     }
 
-   void startSimulation() {
-    while(true) {
-        system("cls");
-        displayNetwork();
-        signalManager->processSignals();
-        emergencyManager->forceSignalOverride(signalManager);
-        signalManager->displaySignalStatus();
-        closureManager->displayClosures();                                //starting our simulation from clocks and timings 
+    // Operator actions, safe to call from any thread: they are queued
+    // without locking and carried out at the start of the next step.
+    // Return false if the queue is full or the text doesn't fit.
+    bool requestSignalOverride(int intersection) {
+        return submit(SimCommand::SIGNAL_OVERRIDE, intersection, -1, "");
+    }
 
-        // Check and update routes for all vehicles
-        Node<string>* current = router->vehicleIds.head;
-        while(current != nullptr) {
-            router->checkAndUpdateRoute(current->data);
-            current = current->next;
+    bool requestClosure(int from, int to, const string& status) {
+        return submit(SimCommand::ROAD_CLOSURE, from, to, status);
+    }
+
+    bool requestVehicle(const string& id, int from, int to) {
+        return submit(SimCommand::ADD_VEHICLE, from, to, id);
+    }
+
+    // Runs the simulation up to second time: queued operator actions first,
+    // then every event due by then in order. Vehicles only cost time when one of
+    // their events comes up.
+    void advanceTo(long time) {
+        applyCommands();
+        releaseGreenSignals();
+        router->refreshPlanner(clock.now());
+
+        SimEvent event;
+        while(events.pop(time, event)) {
+            switch(event.type) {
+                case SimEvent::VEHICLE_EXIT:   runExitBatch(event); break;
+                case SimEvent::EMERGENCY_EXIT: emergencyManager->onSegmentExit(event); break;
+                case SimEvent::SIGNAL_CHANGE:  signalManager->onSignalChange(event); break;
+                case SimEvent::REPAIR_DONE:    closureManager->onRepairDone(event); break;
+            }
+            releaseGreenSignals();
+            eventsProcessed++;
         }
+    }
 
- 
-        cout << "\nEmergency Vehicles:\n";
-        cout << "==================\n";
-        emergencyManager->displayVehicles();
-        
-        cout << "\nRegular Vehicles:\n";
-        cout << "================\n";
-        router->displayVehicles();
-        
-        router->updateAllVehicles();
-        emergencyManager->updatePositions();
-        this_thread::sleep_for(chrono::seconds(1));
+    // Every vehicle has arrived or stopped after a collision
+    bool isSettled() const {
+        return router->movingVehicles() == 0 && emergencyManager->movingVehicles() == 0;
+    }
+
+    // Runs the simulation without pacing or display, jumping from one event
+    // to the next, until it settles or reaches second limit. Returns the
+    // simulated second it stopped at.
+    long runHeadless(long limit) {
+        while(!isSettled()) {
+            long next = events.nextTime();
+            if(next > limit) {
+                advanceTo(limit);
+                break;
+            }
+            advanceTo(next);
+        }
+        return events.now();
+    }
+
+    void writeSummary(ostream& out, double wallSeconds) {
+        out << "Simulation Summary\n";
+        out << "==================\n";
+        out << "Simulated time: " << events.now() << "s (" << fixed << setprecision(2)
+            << clock.hoursElapsed() << " hours)\n";
+        out << "Wall time: " << setprecision(3) << wallSeconds << "s\n";
+        out << "Events processed: " << eventsProcessed << "\n";
+        out << "Vehicles arrived: " << router->arrivedVehicles()
+            << ", stopped (collision or no route): " << router->stoppedVehicles()
+            << ", still en route: " << router->movingVehicles() << "\n";
+        out << "Emergency vehicles arrived: "
+            << emergencyManager->vehicleCount() - emergencyManager->movingVehicles()
+               - emergencyManager->unroutableVehicles()
+            << "/" << emergencyManager->vehicleCount()
+            << ", no route: " << emergencyManager->unroutableVehicles() << "\n";
+        out << "Collisions: " << router->collisions.countNodes() << "\n";
+        analytics->displayMetrics(out);
+        router->displayRouteCacheStats(out);
+    }
+
+    // Renders every menu view from the current state and publishes them to
+    // the UI thread. Called by the simulation thread between seconds.
+    void publishSnapshot() {
+        ostringstream out[DisplaySnapshot::NUM_VIEWS];
+        displayNetwork(out[0]);
+        signalManager->displaySignalStatus(out[1]);
+        router->displayVehiclesPerRoad(out[2]);
+        closureManager->displayClosures(out[3]);
+        emergencyManager->displayVehicles(out[4]);
+        router->displayVehicles(out[5]);
+        router->displayCollisions(out[6]);
+        analytics->displayMetrics(out[7]);
+        router->displayRouteCacheStats(out[7]);
+
+        DisplaySnapshot& snapshot = snapshots.writeBuffer();
+        for(int i = 0; i < DisplaySnapshot::NUM_VIEWS; i++) {
+            snapshot.views[i] = out[i].str();
+        }
+        snapshot.time = events.now();
+        snapshot.version = ++snapshotVersion;
+        snapshots.publish();
+    }
+
+    // UI thread: the views as last published; valid until the next call
+    const DisplaySnapshot& latestSnapshot() {
+        return snapshots.read();
+    }
+
+    // Hands event and the road exits queued right after it for the same
+    // second to the router as one batch
+    void runExitBatch(const SimEvent& first) {
+        exitBatch.clear();
+        exitBatch.push_back(first);
+        SimEvent event;
+        while(events.popNextIf([](const SimEvent& e) { return e.type == SimEvent::VEHICLE_EXIT; }, event)) {
+            exitBatch.push_back(event);
+        }
+        router->refreshPlanner(clock.now());
+        router->onSegmentExits(exitBatch);
+        eventsProcessed += exitBatch.size() - 1;
+    }
+
+    // Lets vehicles waiting at signals that turned green set off
+    void releaseGreenSignals() {
+        int intersection;
+        while(signalManager->takeTurnedGreen(intersection)) {
+            router->releaseWaiting(intersection);
+        }
     }
-}
 };
 
 
@@ -1194,6 +1601,18 @@ void clearScreen() {
     #endif
 }
 
+// Reads a line typed at the prompt, echoing it
+string readInput(const string& prompt) {
+    cout << prompt;
+    string text;
+    for(int c = _getch(); c != '\r' && c != '\n' && c != -1; c = _getch()) {
+        cout << (char)c;
+        text += (char)c;
+    }
+    cout << endl;
+    return text;
+}
+
 void displayMenu() {
     cout << "\nSmart Traffic Management System\n";
     cout << "==============================\n";
@@ -1210,18 +1629,64 @@ void displayMenu() {
 
 }
 
-int main() {
-    CityTrafficSystem system;
+// Runs the loaded scenario to the end as fast as possible, with no menus
+// or screen clearing, and writes the summary to stdout and summaryFile
+int runHeadlessScenario(CityTrafficSystem& system, long limit, const string& summaryFile) {
+    chrono::steady_clock::time_point wallStart = chrono::steady_clock::now();
+    system.runHeadless(limit);
+    double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+
+    cout << "\n";
+    system.writeSummary(cout, wallSeconds);
+    if(!summaryFile.empty()) {
+        ofstream file(summaryFile);
+        if(!file.is_open()) {
+            cerr << "Failed to open file: " << summaryFile << endl;
+            return 1;
+        }
+        system.writeSummary(file, wallSeconds);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    bool headless = false;
+    long limit = 24 * 3600;                         // simulated seconds a headless run may take
+    string summaryFile;
+    int threads = 0;                                // one per hardware thread
+    bool withPlanner = false;                       // live routes from the route planner instead of ALT
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "--headless") {
+            headless = true;
+        } else if(arg == "--until" && i + 1 < argc) {
+            limit = atol(argv[++i]);
+        } else if(arg == "--summary" && i + 1 < argc) {
+            summaryFile = argv[++i];
+        } else if(arg == "--threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if(arg == "--planner") {
+            withPlanner = true;
+        } else {
+            cerr << "Usage: " << argv[0] << " [--threads N] [--planner] [--headless [--until SECONDS] [--summary FILE]]" << endl;
+            return 1;
+        }
+    }
+
+    CityTrafficSystem system(threads, withPlanner);
     system.initializeFromFile("road_network.csv");
+    if(headless) {
+        return runHeadlessScenario(system, limit, summaryFile);
+    }
     
     std::atomic<bool> running{true};
     
+    system.publishSnapshot();
     std::thread updateThread([&]() {
+        long second = 0;                            // one simulated second per real one
         while(running) {
-            system.signalManager->processSignals();
-            system.emergencyManager->forceSignalOverride(system.signalManager);
-            system.router->updateAllVehicles();
-            system.emergencyManager->updatePositions();
+            system.advanceTo(++second);
+            system.publishSnapshot();
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
     });
@@ -1238,59 +1703,53 @@ int main() {
         
         clearScreen();
         bool viewingStatus = true;
-        time_t lastUpdate = time(nullptr);
+        unsigned long shownVersion = 0;             // redraw whenever a newer snapshot is out
         
         while(viewingStatus && running) {
-            if(difftime(time(nullptr), lastUpdate) >= 1) {
+            const DisplaySnapshot& snapshot = system.latestSnapshot();
+            if(snapshot.version != shownVersion && choice >= '1' && choice <= '8') {
                 clearScreen();
                 switch(choice) {
                     case '1':
                         cout << "Graph Connectivity (Press ESC to return)\n";
                         cout << "=======================================\n";
-                        system.displayNetwork();
                         break;
                         
                     case '2':
                         cout << "Traffic Signal Status (Press 'O' to override, ESC to return)\n";
                         cout << "====================================================\n";
-                        system.signalManager->displaySignalStatus();
                         break;
                         
                     case '3':
                         cout << "Vehicles per road (Press ESC to return)\n";
                         cout << "====================================\n";
-                        system.router->displayVehiclesPerRoad();
                         break;
                         
                     case '4':
-                        cout << "Road Blockage Status (Press ESC to return)\n";
+                        cout << "Road Blockage Status (Press 'C' to close a road, ESC to return)\n";
                         cout << "======================================\n";
-                        system.closureManager->displayClosures();
                         break;
                         
                     case '5':
                         cout << "Emergency Vehicle Status (Press ESC to return)\n";
                         cout << "========================================\n";
-                        system.emergencyManager->displayVehicles();
                         break;
                         
                     case '6':
-                        cout << "Vehicle Routing Status (Press ESC to return)\n";
+                        cout << "Vehicle Routing Status (Press 'A' to add a vehicle, ESC to return)\n";
                         cout << "======================================\n";
-                        system.router->displayVehicles();
                         break;
                     case '7':
                         cout << "Collision Reports (Press ESC to return)\n";
                         cout << "================================\n";
-                        system.router->displayCollisions();
                      break;
                      case '8':
                          cout << "Performance Metrics (Press ESC to return)\n";
                          cout << "===================================\n";
-                         system.analytics->displayMetrics();
                      break;
                 }
-                lastUpdate = time(nullptr);
+                cout << snapshot.views[choice - '1'] << flush;
+                shownVersion = snapshot.version;
             }
             
             if(_kbhit()) {
@@ -1299,12 +1758,32 @@ int main() {
                     viewingStatus = false;
                 }
                 else if(choice == '2' && (key == 'o' || key == 'O')) {
-                    cout << "\nEnter intersection to override (A-Z): ";
-                    char intersection = _getch();
-                    cout << intersection << endl;
-                    if(intersection >= 'A' && intersection <= 'Z') {
-                        system.signalManager->emergencyOverride(intersection);
-                        cout << "Signal overridden at intersection " << intersection << endl;
+                    string name = readInput("\nEnter intersection to override: ");
+                    int intersection = system.intersections.find(name);
+                    if(intersection != -1 && system.requestSignalOverride(intersection)) {
+                        cout << "Signal overridden at intersection " << name << endl;
+                        std::this_thread::sleep_for(std::chrono::seconds(1));
+                    }
+                }
+                else if(choice == '4' && (key == 'c' || key == 'C')) {
+                    string from = readInput("\nEnter road start: ");
+                    string to = readInput("Enter road end: ");
+                    string status = readInput("Enter status (Blocked, Under Repair, Clear): ");
+                    int start = system.intersections.find(from);
+                    int end = system.intersections.find(to);
+                    if(start != -1 && end != -1 && system.requestClosure(start, end, status)) {
+                        cout << "Road " << from << " -> " << to << " marked " << status << endl;
+                        std::this_thread::sleep_for(std::chrono::seconds(1));
+                    }
+                }
+                else if(choice == '6' && (key == 'a' || key == 'A')) {
+                    string id = readInput("\nEnter vehicle id: ");
+                    string from = readInput("Enter start intersection: ");
+                    string to = readInput("Enter destination: ");
+                    int start = system.intersections.find(from);
+                    int end = system.intersections.find(to);
+                    if(!id.empty() && start != -1 && end != -1 && system.requestVehicle(id, start, end)) {
+                        cout << "Vehicle " << id << " added at " << from << endl;
                         std::this_thread::sleep_for(std::chrono::seconds(1));
                     }
                 }
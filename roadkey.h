@@ -0,0 +1,36 @@
+#ifndef ROAD_KEY_H
+#define ROAD_KEY_H
+
+#include <cstdint>
+#include <functional>
+
+// Directed pair of intersection ids (a road segment, or a trip's origin and
+// destination) packed into one 64-bit word, for use as a hash table key
+// without building a "from-to" string on every lookup.
+struct RoadKey {
+    uint64_t packed;
+
+    RoadKey() : packed(0) {}
+    RoadKey(int from, int to)
+        : packed(((uint64_t)(uint32_t)from << 32) | (uint32_t)to) {}
+
+    int from() const { return (int)(uint32_t)(packed >> 32); }
+    int to() const { return (int)(uint32_t)packed; }
+
+    bool operator==(const RoadKey& other) const { return packed == other.packed; }
+    bool operator!=(const RoadKey& other) const { return packed != other.packed; }
+};
+
+namespace std {
+    template<>
+    struct hash<RoadKey> {
+        size_t operator()(const RoadKey& key) const {
+            // Fold the halves so tables that use the hash modulo a small
+            // capacity see both ids
+            uint64_t h = key.packed ^ (key.packed >> 29);
+            return (size_t)(h * 0xBF58476D1CE4E5B9ull);
+        }
+    };
+}
+
+#endif // ROAD_KEY_H
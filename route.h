@@ -0,0 +1,74 @@
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include "dynamicarray.h"
+#include "graph.h"
+
+// A vehicle's route stored as the CSR edge ids it drives, in order, with
+// prefix sums of their travel times. Position k is the k-th intersection
+// of the route (0 is the origin, numEdges() the destination), so the road
+// leaving it, the next intersection, the time left and the arrival time
+// are all single indexed loads instead of walks from the head of a list.
+//
+// Travel times are the edge weights when the route was assigned, like the
+// timings the vehicle was given before; later weight changes don't move a
+// trip already under way. Edge ids refer to the snapshot the route was
+// built from.
+class Route {
+private:
+    DynamicArray<int> edges;
+    DynamicArray<int> elapsed;      // elapsed[k] = travel time of edges [0, k)
+    int origin;
+
+public:
+    Route() : origin(-1) {}
+
+    // Rebuilds the route from a path of intersections. The route stops at
+    // the first pair of consecutive intersections with no edge between them.
+    void assign(const CSRGraph& csr, const DynamicArray<int>& path, int from) {
+        edges.clear();
+        elapsed.clear();
+        origin = path.empty() ? from : path[0];
+        elapsed.push_back(0);
+        for (size_t i = 0; i + 1 < path.size(); i++) {
+            int e = csr.findEdge(path[i], path[i + 1]);
+            if (e == -1) break;
+            edges.push_back(e);
+            elapsed.push_back(elapsed.back() + csr.weight(e));
+        }
+    }
+
+    // Keeps the arrays' capacity for the slot's next vehicle
+    void clear() {
+        edges.clear();
+        elapsed.clear();
+        origin = -1;
+    }
+
+    int numEdges() const { return (int)edges.size(); }
+
+    // Edge leaving position k, or -1 at (or past) the destination
+    int edge(int k) const { return k < (int)edges.size() ? edges[k] : -1; }
+
+    // Intersection at position k
+    int intersection(const CSRGraph& csr, int k) const {
+        if (edges.empty()) return origin;
+        return k < (int)edges.size() ? csr.source(edges[k]) : csr.target(edges.back());
+    }
+
+    // Travel time of the edge leaving position k, or -1 if there is none
+    int segmentTime(int k) const {
+        return k < (int)edges.size() ? elapsed[k + 1] - elapsed[k] : -1;
+    }
+
+    int totalTime() const { return elapsed.empty() ? 0 : elapsed.back(); }
+
+    // Time still to drive from position k, timeInSegment into its edge
+    int remainingTime(int k, int timeInSegment) const {
+        if (k >= (int)edges.size()) return 0;
+        int left = totalTime() - elapsed[k] - timeInSegment;
+        return left > 0 ? left : 0;
+    }
+};
+
+#endif // ROUTE_H
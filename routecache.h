@@ -0,0 +1,235 @@
+#ifndef ROUTE_CACHE_H
+#define ROUTE_CACHE_H
+
+#include <climits>
+#include <cstddef>
+#include "graph.h"
+#include "dynamicarray.h"
+#include "searchworkspace.h"
+
+// Cache of shortest-path trees for routes that share an endpoint.
+//
+// A forward tree rooted at s holds the parent of every vertex on its
+// cheapest route from s; a reverse tree rooted at t holds every vertex's next
+// hop toward t. Any route starting at a cached source or ending at a cached
+// destination is then read off a tree in O(route length). A tree costs a full
+// Dijkstra, so one is only built for an endpoint that at least
+// MIN_TREE_DEMAND routes have asked for, and once the budget is full only to
+// replace a tree whose endpoint has been asked for less; every other route
+// gets a point-to-point search instead.
+//
+// Trees are dropped as soon as the version passed to setVersion() changes
+// (edge weights, closures), and the least recently used one is evicted when a
+// new tree would exceed the memory budget. Congestion penalties are priced as
+// they stood when a tree was built.
+class ShortestPathTreeCache {
+private:
+    static const int MIN_TREE_DEMAND = 2;
+
+    struct Tree {
+        int root;
+        bool reverse;
+        int* parent;    // forward: previous vertex, reverse: next hop; -1 if unreachable
+        Tree* prev;     // LRU list, most recent at head
+        Tree* next;
+    };
+
+    DirectedWeightedGraph& graph;
+    int numVertices;
+    size_t maxTrees;
+    size_t numTrees;
+    unsigned long version;
+
+    Tree** forwardTree;  // forwardTree[v]: tree rooted at v, or nullptr
+    Tree** reverseTree;
+    Tree* head;
+    Tree* tail;
+
+    // Routes asked for per endpoint, to root new trees where they pay off most
+    int* sourceDemand;
+    int* destinationDemand;
+
+    const int* edgeCosts;   // nullptr: graph weights
+    long long hits;
+    long long misses;
+    long long evictions;
+
+    void unlink(Tree* tree) {
+        if (tree->prev) tree->prev->next = tree->next;
+        else head = tree->next;
+        if (tree->next) tree->next->prev = tree->prev;
+        else tail = tree->prev;
+    }
+
+    void pushFront(Tree* tree) {
+        tree->prev = nullptr;
+        tree->next = head;
+        if (head) head->prev = tree;
+        head = tree;
+        if (!tail) tail = tree;
+    }
+
+    int demand(const Tree* tree) const {
+        return tree->reverse ? destinationDemand[tree->root] : sourceDemand[tree->root];
+    }
+
+    void touch(Tree* tree) {
+        if (tree == head) return;
+        unlink(tree);
+        pushFront(tree);
+    }
+
+    void destroy(Tree* tree) {
+        unlink(tree);
+        (tree->reverse ? reverseTree : forwardTree)[tree->root] = nullptr;
+        delete[] tree->parent;
+        delete tree;
+        numTrees--;
+    }
+
+    int cost(int e, const CSRGraph& csr) const {
+        return edgeCosts ? edgeCosts[e] : csr.weight(e);
+    }
+
+    // Full Dijkstra from root, over incoming edges for a reverse tree
+    Tree* build(int root, bool reverse) {
+        if (numTrees >= maxTrees) {
+            destroy(tail);
+            evictions++;
+        }
+
+        const CSRGraph& csr = graph.getSnapshot();
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        ws.begin(numVertices);
+        ws.setDistance(root, 0, -1);
+        ws.queue.push(root, 0);
+        while (!ws.queue.empty()) {
+            int u = ws.queue.pop();
+            ws.settle(u);
+            int distU = ws.distance(u);
+            int begin = reverse ? csr.reverseBegin(u) : csr.edgeBegin(u);
+            int end = reverse ? csr.reverseEnd(u) : csr.edgeEnd(u);
+            for (int i = begin; i < end; i++) {
+                int e = reverse ? csr.reverseEdge(i) : i;
+                int w = cost(e, csr);
+                if (w == INT_MAX) continue;
+                int v = reverse ? csr.source(e) : csr.target(e);
+                int newDist = distU + w;
+                if (!ws.isSettled(v) && newDist < ws.distance(v)) {
+                    ws.setDistance(v, newDist, u);
+                    ws.queue.pushOrDecrease(v, newDist);
+                }
+            }
+        }
+
+        Tree* tree = new Tree{root, reverse, new int[numVertices], nullptr, nullptr};
+        for (int v = 0; v < numVertices; v++) {
+            tree->parent[v] = ws.distance(v) == INT_MAX ? -1 : ws.parent(v);
+        }
+        tree->parent[root] = root;
+        (reverse ? reverseTree : forwardTree)[root] = tree;
+        pushFront(tree);
+        numTrees++;
+        return tree;
+    }
+
+    static int readForward(const Tree* tree, int destination, DynamicArray<int>& path) {
+        if (tree->parent[destination] == -1) return 0;
+        for (int v = destination; v != tree->root; v = tree->parent[v]) {
+            path.push_back(v);
+        }
+        path.push_back(tree->root);
+        path.reverse();
+        return (int)path.size();
+    }
+
+    static int readReverse(const Tree* tree, int source, DynamicArray<int>& path) {
+        if (tree->parent[source] == -1) return 0;
+        for (int v = source; v != tree->root; v = tree->parent[v]) {
+            path.push_back(v);
+        }
+        path.push_back(tree->root);
+        return (int)path.size();
+    }
+
+public:
+    // memoryBudget bounds the bytes spent on trees; at least one is kept
+    ShortestPathTreeCache(DirectedWeightedGraph& g, size_t memoryBudget)
+        : graph(g), numVertices(g.getNumVertices()), numTrees(0), version(0),
+          head(nullptr), tail(nullptr), edgeCosts(nullptr), hits(0), misses(0), evictions(0) {
+        size_t treeBytes = sizeof(Tree) + (size_t)numVertices * sizeof(int);
+        maxTrees = memoryBudget / treeBytes;
+        if (maxTrees == 0) maxTrees = 1;
+        forwardTree = new Tree*[numVertices]();
+        reverseTree = new Tree*[numVertices]();
+        sourceDemand = new int[numVertices]();
+        destinationDemand = new int[numVertices]();
+    }
+
+    ~ShortestPathTreeCache() {
+        clear();
+        delete[] forwardTree;
+        delete[] reverseTree;
+        delete[] sourceDemand;
+        delete[] destinationDemand;
+    }
+
+    ShortestPathTreeCache(const ShortestPathTreeCache&) = delete;
+    ShortestPathTreeCache& operator=(const ShortestPathTreeCache&) = delete;
+
+    void clear() {
+        while (head) destroy(head);
+    }
+
+    // Drops every tree if the routing costs changed since the last call;
+    // returns whether they did
+    bool setVersion(unsigned long newVersion) {
+        if (newVersion == version) return false;
+        clear();
+        version = newVersion;
+        return true;
+    }
+
+    // Edge costs by edge id (INT_MAX = closed) for trees built from now on;
+    // nullptr uses the graph's weights. Bump the version when they change.
+    void setEdgeCosts(const int* costs) { edgeCosts = costs; }
+
+    // Same contract as DirectedWeightedGraph::dijkstra. Reads the route off a
+    // cached tree when either endpoint has one, otherwise builds a tree at
+    // whichever endpoint more routes have asked for, once that is at least
+    // MIN_TREE_DEMAND and more than the least recently used tree's endpoint
+    // when the budget is full; otherwise findRoute answers under the same
+    // costs.
+    int route(int source, int destination, DynamicArray<int>& path) {
+        path.clear();
+        if (source < 0 || source >= numVertices || destination < 0 || destination >= numVertices) {
+            return 0;
+        }
+        sourceDemand[source]++;
+        destinationDemand[destination]++;
+
+        Tree* tree = forwardTree[source];
+        if (tree == nullptr) tree = reverseTree[destination];
+        if (tree != nullptr) {
+            hits++;
+            touch(tree);
+        } else {
+            misses++;
+            bool atSource = sourceDemand[source] >= destinationDemand[destination];
+            int asked = atSource ? sourceDemand[source] : destinationDemand[destination];
+            if (asked < MIN_TREE_DEMAND || (numTrees >= maxTrees && asked <= demand(tail))) {
+                return graph.findRoute(source, destination, path, edgeCosts);
+            }
+            tree = atSource ? build(source, false) : build(destination, true);
+        }
+        return tree->reverse ? readReverse(tree, source, path) : readForward(tree, destination, path);
+    }
+
+    long long getHits() const { return hits; }
+    long long getMisses() const { return misses; }
+    long long getEvictions() const { return evictions; }
+    size_t getNumTrees() const { return numTrees; }
+    size_t getMaxTrees() const { return maxTrees; }
+};
+
+#endif // ROUTE_CACHE_H
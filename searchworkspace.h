@@ -0,0 +1,118 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+#include <climits>
+#include "heap.h"
+#include "dynamicarray.h"
+
+// Scratch state for shortest-path searches, reused from one query to the next.
+// Every slot remembers the epoch it was last written in, and starting a search
+// just bumps the epoch, so resetting costs O(1) instead of O(V).
+class SearchWorkspace {
+private:
+    unsigned* reachedEpoch;
+    unsigned* settledEpoch;
+    int* dist;
+    int* prev;
+    int capacity;
+    unsigned epoch;
+
+    void ensureCapacity(int numVertices) {
+        if (numVertices <= capacity) return;
+        int newCapacity = capacity == 0 ? 64 : capacity;
+        while (newCapacity < numVertices) {
+            newCapacity *= 2;
+        }
+        delete[] reachedEpoch;
+        delete[] settledEpoch;
+        delete[] dist;
+        delete[] prev;
+        reachedEpoch = new unsigned[newCapacity]();
+        settledEpoch = new unsigned[newCapacity]();
+        dist = new int[newCapacity];
+        prev = new int[newCapacity];
+        capacity = newCapacity;
+        epoch = 0;
+    }
+
+public:
+    IndexedPriorityQueue<int> queue;
+
+    SearchWorkspace()
+        : reachedEpoch(nullptr), settledEpoch(nullptr), dist(nullptr), prev(nullptr),
+          capacity(0), epoch(0) {}
+
+    ~SearchWorkspace() {
+        delete[] reachedEpoch;
+        delete[] settledEpoch;
+        delete[] dist;
+        delete[] prev;
+    }
+
+    SearchWorkspace(const SearchWorkspace&) = delete;
+    SearchWorkspace& operator=(const SearchWorkspace&) = delete;
+
+    // Starts a new search over a graph with numVertices vertices
+    void begin(int numVertices) {
+        ensureCapacity(numVertices);
+        queue.clear();
+        epoch++;
+        if (epoch == 0) {
+            // The stamp wrapped around: old stamps could look current again
+            for (int i = 0; i < capacity; i++) {
+                reachedEpoch[i] = 0;
+                settledEpoch[i] = 0;
+            }
+            epoch = 1;
+        }
+    }
+
+    int distance(int v) const {
+        return reachedEpoch[v] == epoch ? dist[v] : INT_MAX;
+    }
+
+    int parent(int v) const {
+        return reachedEpoch[v] == epoch ? prev[v] : -1;
+    }
+
+    bool isSettled(int v) const {
+        return settledEpoch[v] == epoch;
+    }
+
+    void settle(int v) {
+        settledEpoch[v] = epoch;
+    }
+
+    // Records a tentative distance d for v, reached through p
+    void setDistance(int v, int d, int p) {
+        reachedEpoch[v] = epoch;
+        dist[v] = d;
+        prev[v] = p;
+    }
+
+    // Fills path with the vertices from the search source to target and
+    // returns how many there are (0 if target was not reached)
+    int buildPath(int target, DynamicArray<int>& path) const {
+        path.clear();
+        if (distance(target) == INT_MAX) return 0;
+        for (int node = target; node != -1; node = parent(node)) {
+            path.push_back(node);
+        }
+        path.reverse();
+        return (int)path.size();
+    }
+
+    // One workspace per thread, so concurrent searches never share buffers
+    static SearchWorkspace& forThisThread() {
+        static thread_local SearchWorkspace workspace;
+        return workspace;
+    }
+
+    // Second per-thread workspace for the backward half of bidirectional searches
+    static SearchWorkspace& reverseForThisThread() {
+        static thread_local SearchWorkspace workspace;
+        return workspace;
+    }
+};
+
+#endif // SEARCH_WORKSPACE_H
@@ -0,0 +1,40 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <atomic>
+#include <ctime>
+
+// Simulated time in whole seconds since the start of a run. The simulation
+// never reads the wall clock: the event queue moves this clock forward as it
+// pops events and everything else asks it for the time, so a run goes as
+// fast as the CPU allows unless its caller paces it to real time.
+//
+// epoch is the calendar time that second 0 stands for. It is only used to
+// print timestamps and to bucket by hour of day.
+class SimClock {
+private:
+    std::atomic<long> seconds;
+    time_t epoch;
+
+public:
+    explicit SimClock(time_t start = time(nullptr)) : seconds(0), epoch(start) {}
+
+    SimClock(const SimClock&) = delete;
+    SimClock& operator=(const SimClock&) = delete;
+
+    // Safe to read from other threads
+    long now() const { return seconds.load(std::memory_order_relaxed); }
+
+    // Moves the clock to second t; it never goes back
+    void advanceTo(long t) {
+        if (t > now()) seconds.store(t, std::memory_order_relaxed);
+    }
+
+    time_t toCalendar(long t) const { return epoch + (time_t)t; }
+    time_t calendarNow() const { return toCalendar(now()); }
+
+    int hourOfDay() const { return (int)((calendarNow() / 3600) % 24); }
+    double hoursElapsed() const { return now() / 3600.0; }
+};
+
+#endif // SIM_CLOCK_H
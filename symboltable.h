@@ -0,0 +1,39 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include "hashtable.h"
+#include "dynamicarray.h"
+
+// Maps intersection names from the CSV files to dense ids 0, 1, 2, ... in
+// the order they are first seen, so the graph and every per-intersection
+// table can be indexed by a plain int whatever the names look like.
+class SymbolTable {
+private:
+    HashTable<std::string, int> ids;
+    DynamicArray<std::string> names;
+
+public:
+    // Id of name, assigning the next free one if it is new
+    int intern(const std::string& name) {
+        int id;
+        if (ids.get(name, id)) return id;
+        id = (int)names.size();
+        ids.insert(name, id);
+        names.push_back(name);
+        return id;
+    }
+
+    // Id of name, or -1 if it was never interned
+    int find(const std::string& name) const {
+        int id;
+        return ids.get(name, id) ? id : -1;
+    }
+
+    const std::string& name(int id) const { return names[id]; }
+
+    bool contains(int id) const { return id >= 0 && id < (int)names.size(); }
+    int size() const { return (int)names.size(); }
+};
+
+#endif // SYMBOL_TABLE_H
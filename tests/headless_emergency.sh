@@ -0,0 +1,41 @@
+#!/bin/sh
+# Headless regression check: an emergency vehicle whose start is its
+# destination arrives at once, one whose destination is unreachable stops,
+# and neither keeps the run going until --until.
+#
+#   sh tests/headless_emergency.sh [path/to/traffic_system]
+set -e
+
+BINARY=$(cd "$(dirname "${1:-./traffic_system}")" && pwd)/$(basename "${1:-./traffic_system}")
+SCENARIO=$(mktemp -d)
+trap 'rm -rf "$SCENARIO"' EXIT
+cd "$SCENARIO"
+
+cat > road_network.csv <<'CSV'
+Intersection1,Intersection2,TravelTime
+A,B,10
+B,C,10
+C,D,10
+E,A,10
+CSV
+cat > emergency_vehicles.csv <<'CSV'
+VehicleID,StartIntersection,EndIntersection,Priority
+E1,A,A,High
+E2,A,E,Medium
+E3,A,D,High
+CSV
+printf 'VehicleID,StartIntersection,EndIntersection\n' > vehicles.csv
+printf 'Intersection,GreenTime\n' > traffic_signals.csv
+printf 'Intersection1,Intersection2,Status\n' > road_closures.csv
+
+"$BINARY" --headless --until 100000 --summary summary.txt > /dev/null
+
+fail=0
+grep -q "Emergency vehicles arrived: 2/3, no route: 1" summary.txt || fail=1
+grep -q "Simulated time: 100000s" summary.txt && fail=1
+if [ "$fail" -ne 0 ]; then
+    echo "FAIL: headless emergency vehicles"
+    cat summary.txt
+    exit 1
+fi
+echo "PASS: headless emergency vehicles"
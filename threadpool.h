@@ -0,0 +1,112 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Fixed set of worker threads for data-parallel loops. parallelFor splits
+// [0, n) into one contiguous chunk per thread, in order: worker 0 (the
+// calling thread) takes the first chunk, worker 1 the next, and so on. The
+// split depends only on n and the thread count, so per-worker results
+// merged in worker order come out in index order whatever the number of
+// threads.
+class ThreadPool {
+private:
+    std::thread* workers;                   // threads for workers 1..numThreads-1
+    int numThreads;
+
+    std::mutex lock;
+    std::condition_variable wake;           // a round started or the pool is stopping
+    std::condition_variable done;           // the last chunk of a round finished
+    std::function<void(size_t, size_t, int)> job;
+    size_t jobSize;
+    int jobChunks;
+    int unfinished;                         // chunks of the round still running
+    unsigned long round;
+    bool stopping;
+
+    size_t chunkBegin(int chunk) const { return jobSize * chunk / jobChunks; }
+
+    void workerLoop(int worker) {
+        unsigned long seen = 0;
+        while (true) {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&]() { return stopping || round != seen; });
+            if (stopping) return;
+            seen = round;
+            if (worker >= jobChunks) continue;
+            guard.unlock();
+
+            job(chunkBegin(worker), chunkBegin(worker + 1), worker);
+
+            guard.lock();
+            if (--unfinished == 0) done.notify_one();
+        }
+    }
+
+public:
+    // threads <= 0 uses one per hardware thread
+    explicit ThreadPool(int threads = 0)
+        : workers(nullptr), numThreads(threads), jobSize(0), jobChunks(0), unfinished(0), round(0),
+          stopping(false) {
+        if (numThreads <= 0) numThreads = (int)std::thread::hardware_concurrency();
+        if (numThreads <= 0) numThreads = 1;
+        if (numThreads > 1) {
+            workers = new std::thread[numThreads - 1];
+            for (int i = 1; i < numThreads; i++) {
+                workers[i - 1] = std::thread(&ThreadPool::workerLoop, this, i);
+            }
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (int i = 0; i < numThreads - 1; i++) workers[i].join();
+        delete[] workers;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return numThreads; }
+
+    // Calls body(begin, end, worker) for each chunk of [0, n) and returns
+    // once all have finished. Chunks have at least minChunk items, so small
+    // loops run on the calling thread alone. Only one thread may call this
+    // at a time.
+    template<typename F>
+    void parallelFor(size_t n, size_t minChunk, F body) {
+        if (n == 0) return;
+        size_t chunks = minChunk > 0 ? (n + minChunk - 1) / minChunk : n;
+        if (chunks > (size_t)numThreads) chunks = numThreads;
+        if (chunks <= 1) {
+            body(0, n, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            job = body;
+            jobSize = n;
+            jobChunks = (int)chunks;
+            unfinished = (int)chunks - 1;
+            round++;
+        }
+        wake.notify_all();
+
+        body(chunkBegin(0), chunkBegin(1), 0);
+
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [&]() { return unfinished == 0; });
+        job = nullptr;
+    }
+};
+
+#endif // THREAD_POOL_H
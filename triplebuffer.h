@@ -0,0 +1,50 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Hands whole values from one writer thread to one reader thread without
+// either ever waiting for the other. There are three buffers: the writer
+// fills its back buffer and publishes it by swapping it with the middle
+// one; the reader takes the middle buffer in exchange for its front one
+// when something new was published. A published buffer is never written
+// again until the reader has given it back, so the reader sees each value
+// whole and unchanging, and always the latest one published.
+template<typename T>
+class TripleBuffer {
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;                 // middle holds a value the reader hasn't taken
+
+    T buffers[3];
+    std::atomic<int> middle;                    // buffer index, plus FRESH
+    int back;                                   // writer's
+    int front;                                  // reader's
+
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer: the buffer to fill before the next publish(). It may still
+    // hold an older value.
+    T& writeBuffer() { return buffers[back]; }
+
+    // Writer: makes the filled buffer the latest value
+    void publish() {
+        int previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+    }
+
+    // Reader: the latest published value, valid until the next read()
+    const T& read() {
+        if (middle.load(std::memory_order_acquire) & FRESH) {
+            int previous = middle.exchange(front, std::memory_order_acq_rel);
+            front = previous & INDEX_MASK;
+        }
+        return buffers[front];
+    }
+};
+
+#endif // TRIPLE_BUFFER_H
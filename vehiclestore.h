@@ -0,0 +1,169 @@
+#ifndef VEHICLE_STORE_H
+#define VEHICLE_STORE_H
+
+#include <cstdint>
+#include <string>
+#include "dynamicarray.h"
+#include "route.h"
+
+// Refers to a vehicle in a VehicleStore: its slot plus the slot's generation
+// when the vehicle was added. Slots are reused once a vehicle is released,
+// and the generation is bumped each time, so a handle kept past release is
+// detected as stale instead of silently reaching the slot's next vehicle.
+struct VehicleHandle {
+    uint32_t slot;
+    uint32_t generation;
+
+    VehicleHandle() : slot(UINT32_MAX), generation(0) {}
+    VehicleHandle(uint32_t s, uint32_t g) : slot(s), generation(g) {}
+};
+
+// Regular vehicles stored column by column (struct of arrays). The state the
+// simulation reads for every vehicle - current intersection and road, route
+// cursor, segment start and flags - sits in its own dense arrays indexed by
+// slot, so a sweep over all vehicles walks contiguous memory instead of
+// hashing ids.
+// Ids, trip endpoints and routes are cold columns, only read when a vehicle
+// changes segment or is displayed. The hot columns are a cache of the route
+// at the cursor, refreshed whenever either changes.
+//
+// Released slots go on a free list and are handed out again by add(), so the
+// slot range stays as large as the peak number of vehicles on the road.
+class VehicleStore {
+public:
+    static const uint8_t LIVE = 1;          // slot holds a vehicle
+    static const uint8_t IN_TRANSIT = 2;    // vehicle is moving
+
+private:
+    // Hot columns
+    DynamicArray<int> locations;            // intersection the vehicle is at or leaving
+    DynamicArray<int> currentEdges;         // CSR edge id of the road being driven, -1 if none
+    DynamicArray<int> cursors;              // index of the current intersection in the route
+    DynamicArray<long> segmentStarts;       // second it entered the current road, -1 while waiting
+    DynamicArray<int> segmentDurations;     // seconds the current road takes
+    DynamicArray<uint8_t> flags;
+
+    // Cold columns
+    DynamicArray<uint32_t> generations;
+    DynamicArray<std::string> ids;
+    DynamicArray<int> starts;
+    DynamicArray<int> ends;
+    DynamicArray<Route> routes;
+
+    DynamicArray<uint32_t> freeSlots;
+    size_t liveCount;
+    size_t inTransitCount;
+
+public:
+    VehicleStore() : liveCount(0), inTransitCount(0) {}
+
+    VehicleStore(const VehicleStore&) = delete;
+    VehicleStore& operator=(const VehicleStore&) = delete;
+
+    // Sizes every column for n vehicles
+    void reserve(size_t n) {
+        locations.reserve(n);
+        currentEdges.reserve(n);
+        cursors.reserve(n);
+        segmentStarts.reserve(n);
+        segmentDurations.reserve(n);
+        flags.reserve(n);
+        generations.reserve(n);
+        ids.reserve(n);
+        starts.reserve(n);
+        ends.reserve(n);
+        routes.reserve(n);
+    }
+
+    // New in-transit vehicle at start with no route yet
+    VehicleHandle add(const std::string& id, int start, int end) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = (uint32_t)flags.size();
+            locations.push_back(0);
+            currentEdges.push_back(-1);
+            cursors.push_back(0);
+            segmentStarts.push_back(-1);
+            segmentDurations.push_back(0);
+            flags.push_back(0);
+            generations.push_back(0);
+            ids.push_back(std::string());
+            starts.push_back(0);
+            ends.push_back(0);
+            routes.push_back(Route());
+        }
+        locations[slot] = start;
+        currentEdges[slot] = -1;
+        cursors[slot] = 0;
+        segmentStarts[slot] = -1;
+        segmentDurations[slot] = 0;
+        flags[slot] = LIVE | IN_TRANSIT;
+        ids[slot] = id;
+        starts[slot] = start;
+        ends[slot] = end;
+        liveCount++;
+        inTransitCount++;
+        return VehicleHandle(slot, generations[slot]);
+    }
+
+    // Frees the vehicle's slot for reuse; its handles become stale
+    void release(uint32_t slot) {
+        if (!(flags[slot] & LIVE)) return;
+        routes[slot].clear();
+        if (flags[slot] & IN_TRANSIT) inTransitCount--;
+        flags[slot] = 0;
+        generations[slot]++;
+        freeSlots.push_back(slot);
+        liveCount--;
+    }
+
+    bool isValid(VehicleHandle handle) const {
+        return handle.slot < flags.size() && (flags[handle.slot] & LIVE) &&
+               generations[handle.slot] == handle.generation;
+    }
+
+    VehicleHandle handleOf(uint32_t slot) const { return VehicleHandle(slot, generations[slot]); }
+
+    // Slots are [0, slotCount()); released ones are not live
+    size_t slotCount() const { return flags.size(); }
+    size_t size() const { return liveCount; }
+    size_t movingCount() const { return inTransitCount; }
+
+    bool isLive(uint32_t slot) const { return flags[slot] & LIVE; }
+    bool isInTransit(uint32_t slot) const { return flags[slot] & IN_TRANSIT; }
+
+    void setInTransit(uint32_t slot, bool moving) {
+        if (moving == isInTransit(slot)) return;
+        if (moving) {
+            flags[slot] |= IN_TRANSIT;
+            inTransitCount++;
+        } else {
+            flags[slot] &= ~IN_TRANSIT;
+            inTransitCount--;
+        }
+    }
+
+    int& location(uint32_t slot) { return locations[slot]; }
+    int& currentEdge(uint32_t slot) { return currentEdges[slot]; }
+    int& cursor(uint32_t slot) { return cursors[slot]; }
+    long& segmentStart(uint32_t slot) { return segmentStarts[slot]; }
+    int& segmentDuration(uint32_t slot) { return segmentDurations[slot]; }
+
+    int location(uint32_t slot) const { return locations[slot]; }
+    int currentEdge(uint32_t slot) const { return currentEdges[slot]; }
+    int cursor(uint32_t slot) const { return cursors[slot]; }
+    long segmentStart(uint32_t slot) const { return segmentStarts[slot]; }
+    int segmentDuration(uint32_t slot) const { return segmentDurations[slot]; }
+
+    const std::string& id(uint32_t slot) const { return ids[slot]; }
+    int start(uint32_t slot) const { return starts[slot]; }
+    int end(uint32_t slot) const { return ends[slot]; }
+
+    Route& route(uint32_t slot) { return routes[slot]; }
+    const Route& route(uint32_t slot) const { return routes[slot]; }
+};
+
+#endif // VEHICLE_STORE_H